@@ -0,0 +1,190 @@
+/*
+ * npPairCount.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: npadmana
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "npPairCount.h"
+
+using namespace std;
+using namespace Eigen;
+
+void countPairsBrute(const PointSet& pp, Histogram2D& h1, int offset, int stride) {
+	double rr, mu;
+	int npart = pp.size();
+	for (int ii=offset; ii < npart; ii+=stride) {
+		Vector3d x = pp.pos(ii);
+		for (int jj=0; jj < npart; ++jj) {
+			compute_rmu(x, pp.pos(jj), rr, mu);
+			h1.add(rr, mu, pp.weight(ii)*pp.weight(jj));
+		}
+	}
+}
+
+void countPairsBruteSymmetric(const PointSet& pp, Histogram2D& h1, bool selfpairs, int offset, int stride) {
+	double rr, mu;
+	int npart = pp.size();
+	for (int ii=offset; ii < npart; ii+=stride) {
+		Vector3d x = pp.pos(ii);
+		double wx = pp.weight(ii);
+		if (selfpairs) {
+			compute_rmu(x, x, rr, mu);
+			h1.add(rr, mu, wx*wx);
+		}
+		for (int jj=ii+1; jj < npart; ++jj) {
+			compute_rmu(x, pp.pos(jj), rr, mu);
+			h1.add(rr, mu, wx*pp.weight(jj));
+			h1.add(rr, -mu, wx*pp.weight(jj));
+		}
+	}
+}
+
+void countPairsBruteCross(const PointSet& p1, const PointSet& p2, Histogram2D& h1, int offset, int stride) {
+	double rr, mu;
+	for (int ii=offset; ii < p1.size(); ii+=stride) {
+		Vector3d x = p1.pos(ii);
+		for (int jj=0; jj < p2.size(); ++jj) {
+			compute_rmu(x, p2.pos(jj), rr, mu);
+			h1.add(rr, mu, p1.weight(ii)*p2.weight(jj));
+		}
+	}
+}
+
+
+PairGrid::PairGrid(const PointSet& pp, double rmax, int maxcells) : pts_(pp) {
+	int npart = pp.size();
+
+	// Bounding box
+	Vector3d x1;
+	x0_.setZero(); x1.setZero();
+	if (npart > 0) {
+		x0_ = pp.pos(0); x1 = pp.pos(0);
+	}
+	for (int ii=0; ii < npart; ++ii) {
+		x0_ = x0_.cwiseMin(pp.pos(ii));
+		x1 = x1.cwiseMax(pp.pos(ii));
+	}
+
+	// Cells must be at least rmax on a side; the cap on the number of cells
+	// keeps the memory bounded when rmax is small compared to the box.
+	double extent = (x1-x0_).maxCoeff();
+	cellsize_ = max(rmax, extent/maxcells);
+	if (cellsize_ <= 0.0) cellsize_ = 1.0;
+	for (int idim=0; idim < 3; ++idim)
+		nc_[idim] = static_cast<int>((x1[idim]-x0_[idim])/cellsize_) + 1;
+
+	// Counting sort of the points into cells
+	vector<int> icell(npart);
+	start_.assign(ncells()+1, 0);
+	for (int ii=0; ii < npart; ++ii) {
+		icell[ii] = (cell1d(pp.x()[ii],0)*nc_[1] + cell1d(pp.y()[ii],1))*nc_[2] + cell1d(pp.z()[ii],2);
+		start_[icell[ii]+1]++;
+	}
+	for (int ic=0; ic < ncells(); ++ic) start_[ic+1] += start_[ic];
+
+	// Reorder the points, so each cell is a contiguous block
+	vector<int> fill(start_.begin(), start_.end()-1), order(npart);
+	for (int ii=0; ii < npart; ++ii) order[fill[icell[ii]]++] = ii;
+	pts_.permute(order);
+	maxcount_ = 0;
+	for (int ic=0; ic < ncells(); ++ic) maxcount_ = max(maxcount_, start_[ic+1]-start_[ic]);
+}
+
+int PairGrid::ncells() const {
+	return nc_[0]*nc_[1]*nc_[2];
+}
+
+int PairGrid::cell1d(double x, int idim) const {
+	int ic = static_cast<int>((x-x0_[idim])/cellsize_);
+	return min(max(ic, 0), nc_[idim]-1);
+}
+
+void PairGrid::addBlock(Histogram2D& h1, const Vector3d& x, double wx, int jlo, int jhi,
+		bool mirror, double *rr, double *mu, double *wpair) const {
+	int nj = jhi-jlo;
+	if (nj <= 0) return;
+	compute_rmu_block(x, pts_.x()+jlo, pts_.y()+jlo, pts_.z()+jlo, nj, rr, mu);
+	const double *w = pts_.w();
+	if (w != NULL)
+		for (int jj=0; jj < nj; ++jj) wpair[jj] = wx*w[jlo+jj];
+
+	// Add the pairs, and then the mirror pairs at -mu
+	for (int pass=0; pass < (mirror ? 2 : 1); ++pass) {
+		if (pass == 1)
+			for (int jj=0; jj < nj; ++jj) mu[jj] = -mu[jj];
+		if (w == NULL)
+			h1.addConstant(rr, mu, nj, wx);
+		else
+			h1.add(rr, mu, wpair, nj);
+	}
+}
+
+void PairGrid::countPairs(Histogram2D& h1, int offset, int stride) const {
+	vector<double> rr(maxcount_), mu(maxcount_), wpair(maxcount_);
+	for (int ic=offset; ic < ncells(); ic+=stride) {
+		if (start_[ic] == start_[ic+1]) continue;
+		int i0 = ic/(nc_[1]*nc_[2]);
+		int i1 = (ic/nc_[2])%nc_[1];
+		int i2 = ic%nc_[2];
+
+		// Loop over neighbouring cells, including this one
+		for (int j0=max(i0-1,0); j0 <= min(i0+1, nc_[0]-1); ++j0)
+		for (int j1=max(i1-1,0); j1 <= min(i1+1, nc_[1]-1); ++j1)
+		for (int j2=max(i2-1,0); j2 <= min(i2+1, nc_[2]-1); ++j2) {
+			int jc = (j0*nc_[1] + j1)*nc_[2] + j2;
+			for (int ii=start_[ic]; ii < start_[ic+1]; ++ii)
+				addBlock(h1, pts_.pos(ii), pts_.weight(ii), start_[jc], start_[jc+1], false, &rr[0], &mu[0], &wpair[0]);
+		}
+	}
+}
+
+void PairGrid::countPairsSymmetric(Histogram2D& h1, bool selfpairs, int offset, int stride) const {
+	vector<double> rr(maxcount_), mu(maxcount_), wpair(maxcount_);
+	for (int ic=offset; ic < ncells(); ic+=stride) {
+		if (start_[ic] == start_[ic+1]) continue;
+		int i0 = ic/(nc_[1]*nc_[2]);
+		int i1 = (ic/nc_[2])%nc_[1];
+		int i2 = ic%nc_[2];
+
+		// Loop over neighbouring cells, including this one, but only
+		// take each pair of cells once
+		for (int j0=max(i0-1,0); j0 <= min(i0+1, nc_[0]-1); ++j0)
+		for (int j1=max(i1-1,0); j1 <= min(i1+1, nc_[1]-1); ++j1)
+		for (int j2=max(i2-1,0); j2 <= min(i2+1, nc_[2]-1); ++j2) {
+			int jc = (j0*nc_[1] + j1)*nc_[2] + j2;
+			if (jc < ic) continue;
+			for (int ii=start_[ic]; ii < start_[ic+1]; ++ii) {
+				Vector3d x = pts_.pos(ii);
+				double wx = pts_.weight(ii);
+				int jstart = start_[jc];
+				if (jc == ic) {
+					if (selfpairs) addBlock(h1, x, wx, ii, ii+1, false, &rr[0], &mu[0], &wpair[0]);
+					jstart = ii+1;
+				}
+				addBlock(h1, x, wx, jstart, start_[jc+1], true, &rr[0], &mu[0], &wpair[0]);
+			}
+		}
+	}
+}
+
+void PairGrid::countCrossPairs(const PointSet& pp, Histogram2D& h1, int offset, int stride) const {
+	vector<double> rr(maxcount_), mu(maxcount_), wpair(maxcount_);
+	int npart = pp.size();
+	for (int ii=offset; ii < npart; ii+=stride) {
+		Vector3d x = pp.pos(ii);
+		double wx = pp.weight(ii);
+
+		// Points outside the grid are clamped to the edge cells; any
+		// grid points within rmax are still in the neighbouring cells.
+		int i0 = cell1d(x[0],0), i1 = cell1d(x[1],1), i2 = cell1d(x[2],2);
+		for (int j0=max(i0-1,0); j0 <= min(i0+1, nc_[0]-1); ++j0)
+		for (int j1=max(i1-1,0); j1 <= min(i1+1, nc_[1]-1); ++j1)
+		for (int j2=max(i2-1,0); j2 <= min(i2+1, nc_[2]-1); ++j2) {
+			int jc = (j0*nc_[1] + j1)*nc_[2] + j2;
+			addBlock(h1, x, wx, start_[jc], start_[jc+1], false, &rr[0], &mu[0], &wpair[0]);
+		}
+	}
+}
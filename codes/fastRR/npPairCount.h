@@ -0,0 +1,235 @@
+/*
+ * npPairCount.h
+ *
+ *  Pair counting engines for the fastRR codes.
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: npadmana
+ */
+
+#ifndef NPPAIRCOUNT_H_
+#define NPPAIRCOUNT_H_
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <Eigen/Core>
+
+#include "npHistogram2D.h"
+#include "npPointSet.h"
+
+/** Compute the separation and mu for a pair of points
+ *
+ * The line of sight is defined by the midpoint l=(x+y)/2, and the separation
+ * by s=x-y. mu is then the cosine of the angle between l and s.
+ *
+ * @param x (Vector3d) : first point
+ * @param y (Vector3d) : second point
+ * @param rr (double) : returns the separation
+ * @param mu (double) : returns mu
+ */
+void compute_rmu(const Eigen::Vector3d& x, const Eigen::Vector3d& y, double &rr, double &mu);
+
+/** Compute the separation and mu for a point and a block of points
+ *
+ * This is the batched version of compute_rmu, with the block of points
+ * stored as a structure of arrays. The results are bit for bit identical
+ * to calling compute_rmu on each pair.
+ *
+ * The work is done by an AVX-512, AVX2 or scalar kernel; the best one the CPU
+ * supports is picked at startup, but this can be overridden by selectRmuKernel.
+ *
+ * @param x (Vector3d) : first point
+ * @param bx, by, bz (double*) : coordinates of the n points in the block
+ * @param n (int) : number of points in the block
+ * @param rr (double*) : returns the n separations
+ * @param mu (double*) : returns the n values of mu
+ */
+void compute_rmu_block(const Eigen::Vector3d& x, const double *bx, const double *by, const double *bz,
+		int n, double *rr, double *mu);
+
+/** Select the kernel used by compute_rmu_block
+ *
+ * This is not thread safe, and should be called before any counting starts.
+ *
+ * @param name (string) : one of auto, scalar, avx2 or avx512
+ *
+ * returns false if the kernel is unknown or not supported on this CPU
+ */
+bool selectRmuKernel(const std::string& name);
+
+/// Name of the kernel used by compute_rmu_block
+std::string rmuKernelName();
+
+/** Count all pairs by brute force
+ *
+ * Every ordered pair (including self pairs) is visited, and (r, mu) is added
+ * into the histogram with the product of the weights of the two points.
+ * This is O(N^2), and is retained for validation.
+ *
+ * The outer loop can be split into interleaved pieces, by only doing
+ * the points offset, offset+stride, offset+2*stride...
+ *
+ * @param pp (PointSet) : positions
+ * @param h1 (Histogram2D) : histogram to accumulate into
+ * @param offset (int) : first point of the outer loop [0]
+ * @param stride (int) : stride of the outer loop [1]
+ */
+void countPairsBrute(const PointSet& pp, Histogram2D& h1, int offset=0, int stride=1);
+
+/** Count all pairs by brute force, using the pair symmetry
+ *
+ * Swapping the points in a pair leaves r unchanged and flips the sign of mu,
+ * so only the pairs jj > ii are computed, and each is added in at both
+ * mu and -mu. This gives the same histogram as countPairsBrute in about
+ * half the time.
+ *
+ * @param pp (PointSet) : positions
+ * @param h1 (Histogram2D) : histogram to accumulate into
+ * @param selfpairs (bool) : include the ii==jj pairs
+ * @param offset (int) : first point of the outer loop [0]
+ * @param stride (int) : stride of the outer loop [1]
+ */
+void countPairsBruteSymmetric(const PointSet& pp, Histogram2D& h1, bool selfpairs, int offset=0, int stride=1);
+
+/** Count all cross pairs between two sets of points by brute force
+ *
+ * The pairs are ordered with the first point from p1 and the second from p2.
+ *
+ * @param p1 (PointSet) : first set of positions
+ * @param p2 (PointSet) : second set of positions
+ * @param h1 (Histogram2D) : histogram to accumulate into
+ * @param offset (int) : first point of the outer loop over p1 [0]
+ * @param stride (int) : stride of the outer loop [1]
+ */
+void countPairsBruteCross(const PointSet& p1, const PointSet& p2, Histogram2D& h1, int offset=0, int stride=1);
+
+
+/** A cell list (chaining mesh) for pair counting
+ *
+ * The points are binned into cubical cells at least rmax on a side, so all
+ * pairs closer than rmax are in the same or adjacent cells. Pairs further
+ * apart than this are never visited.
+ *
+ * The visited pairs are exactly the ordered pairs (including self pairs)
+ * that the brute force counter would visit, less those that are more than
+ * rmax apart. Since the histogram drops these anyway, the counts agree bin
+ * for bin, as long as rmax is at least the upper edge of the histogram.
+ *
+ * The grid keeps its own copy of the points, sorted by cell, so that
+ * compute_rmu_block can work on whole cells. Pairs are weighted by the
+ * product of the weights of the two points.
+ */
+class PairGrid {
+public :
+	/** Constructor
+	 *
+	 * @param pp (PointSet) : positions
+	 * @param rmax (double) : maximum separation of interest
+	 * @param maxcells (int) : maximum number of cells in any dimension [256]
+	 */
+	PairGrid(const PointSet& pp, double rmax, int maxcells=256);
+
+	/// Total number of cells
+	int ncells() const;
+
+	/** Count pairs into a histogram
+	 *
+	 * The outer loop over cells can be split into interleaved pieces, by
+	 * only doing the cells offset, offset+stride, offset+2*stride...
+	 *
+	 * @param h1 (Histogram2D) : histogram to accumulate into
+	 * @param offset (int) : first cell of the outer loop [0]
+	 * @param stride (int) : stride of the outer loop [1]
+	 */
+	void countPairs(Histogram2D& h1, int offset=0, int stride=1) const;
+
+	/** Count pairs into a histogram, using the pair symmetry
+	 *
+	 * Only cell pairs with jc >= ic, and point pairs jj > ii within a cell
+	 * are visited; each pair is added in at both mu and -mu. See
+	 * countPairsBruteSymmetric.
+	 *
+	 * @param h1 (Histogram2D) : histogram to accumulate into
+	 * @param selfpairs (bool) : include the self pairs
+	 * @param offset (int) : first cell of the outer loop [0]
+	 * @param stride (int) : stride of the outer loop [1]
+	 */
+	void countPairsSymmetric(Histogram2D& h1, bool selfpairs, int offset=0, int stride=1) const;
+
+	/** Count cross pairs between a set of points and the grid points
+	 *
+	 * The pairs are ordered with the first point from pp, and the second
+	 * from the grid. See countPairsBruteCross.
+	 *
+	 * @param pp (PointSet) : points to cross with the grid
+	 * @param h1 (Histogram2D) : histogram to accumulate into
+	 * @param offset (int) : first point of the outer loop over pp [0]
+	 * @param stride (int) : stride of the outer loop [1]
+	 */
+	void countCrossPairs(const PointSet& pp, Histogram2D& h1, int offset=0, int stride=1) const;
+
+private :
+	// Grid geometry
+	Eigen::Vector3d x0_;
+	double cellsize_;
+	int nc_[3];
+
+	// Points sorted by cell; the points in cell ic
+	// are pts_[start_[ic]] ... pts_[start_[ic+1]-1]
+	PointSet pts_;
+	std::vector<int> start_;
+
+	// Largest number of points in a cell
+	int maxcount_;
+
+	// Cell index along one dimension
+	int cell1d(double x, int idim) const;
+
+	// Add pairs between x and the grid points jlo...jhi-1 into the histogram,
+	// also at -mu if mirror is set. rr, mu and wpair are scratch space.
+	void addBlock(Histogram2D& h1, const Eigen::Vector3d& x, double wx, int jlo, int jhi,
+			bool mirror, double *rr, double *mu, double *wpair) const;
+};
+
+/** Run a pair counter over several threads
+ *
+ * Each thread accumulates into its own private copy of the histogram,
+ * so there is no locking. The copies are merged into h1 at the end, in
+ * thread order; for integer weights, the result is identical to a
+ * serial run.
+ *
+ * The work may additionally be split between several processes, in which
+ * case this process only does piece ipart of npart.
+ *
+ * @param nthreads (int) : number of threads
+ * @param h1 (Histogram2D) : histogram to accumulate into
+ * @param func : called as func(Histogram2D& h, int offset, int stride)
+ *        from each thread. The threads on all processes are numbered
+ *        consecutively; offset is the thread number and stride the
+ *        total number of threads.
+ * @param ipart (int) : piece of the work done by this process [0]
+ * @param npart (int) : number of pieces the work is split into [1]
+ */
+template <class Function>
+void countPairsThreaded(int nthreads, Histogram2D& h1, Function func, int ipart=0, int npart=1) {
+	if (nthreads <= 1) {
+		func(h1, ipart, npart);
+		return;
+	}
+
+	std::vector<Histogram2D> hlist(nthreads, h1);
+	std::vector<std::thread> threads;
+	for (int it=0; it < nthreads; ++it) {
+		threads.push_back(std::thread([&hlist, &func, it, nthreads, ipart, npart]() {
+			hlist[it].reset();
+			func(hlist[it], ipart*nthreads + it, npart*nthreads);
+		}));
+	}
+	for (std::thread &t : threads) t.join();
+
+	for (Histogram2D &h : hlist) h1.merge(h);
+}
+
+
+#endif /* NPPAIRCOUNT_H_ */
@@ -0,0 +1,80 @@
+/*
+ * npPointSet.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: npadmana
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include "npPointSet.h"
+
+using namespace std;
+
+namespace {
+
+// Spread the lower 21 bits of x so there are two zero bits between each
+uint64_t spreadBits(uint64_t x) {
+	x &= 0x1fffff;
+	x = (x | x << 32) & 0x1f00000000ffffULL;
+	x = (x | x << 16) & 0x1f0000ff0000ffULL;
+	x = (x | x << 8)  & 0x100f00f00f00f00fULL;
+	x = (x | x << 4)  & 0x10c30c30c30c30c3ULL;
+	x = (x | x << 2)  & 0x1249249249249249ULL;
+	return x;
+}
+
+}
+
+PointSet::PointSet(int npart, bool weighted) : weighted_(weighted) {
+	resize(npart);
+}
+
+void PointSet::resize(int npart) {
+	x_.resize(npart); y_.resize(npart); z_.resize(npart);
+	if (weighted_) w_.resize(npart);
+}
+
+void PointSet::permute(const vector<int>& order) {
+	int npart = size();
+	Array tmp(npart);
+	Array* arrs[4] = {&x_, &y_, &z_, &w_};
+	for (int ia=0; ia < (weighted_ ? 4 : 3); ++ia) {
+		Array &a = *arrs[ia];
+		for (int ii=0; ii < npart; ++ii) tmp[ii] = a[order[ii]];
+		a.swap(tmp);
+	}
+}
+
+void PointSet::mortonSort() {
+	int npart = size();
+	if (npart == 0) return;
+
+	// Bounding box
+	const Array* arrs[3] = {&x_, &y_, &z_};
+	double lo[3], scale[3];
+	for (int idim=0; idim < 3; ++idim) {
+		const Array &a = *arrs[idim];
+		auto mm = minmax_element(a.begin(), a.end());
+		lo[idim] = *mm.first;
+		double extent = *mm.second - *mm.first;
+		scale[idim] = (extent > 0.0) ? 2097151.0/extent : 0.0;
+	}
+
+	// Compute keys and sort
+	vector<pair<uint64_t, int> > keys(npart);
+	for (int ii=0; ii < npart; ++ii) {
+		uint64_t key = 0;
+		for (int idim=0; idim < 3; ++idim) {
+			uint64_t ix = static_cast<uint64_t>(((*arrs[idim])[ii]-lo[idim])*scale[idim]);
+			key |= spreadBits(ix) << idim;
+		}
+		keys[ii] = make_pair(key, ii);
+	}
+	sort(keys.begin(), keys.end());
+
+	vector<int> order(npart);
+	for (int ii=0; ii < npart; ++ii) order[ii] = keys[ii].second;
+	permute(order);
+}
@@ -0,0 +1,138 @@
+/*
+ * npPointSet.h
+ *
+ *  Structure of arrays storage for points.
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: npadmana
+ */
+
+#ifndef NPPOINTSET_H_
+#define NPPOINTSET_H_
+
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include <Eigen/Core>
+
+/** Minimal allocator returning memory aligned to Align bytes
+ *
+ * Used to start arrays on a cache line boundary.
+ */
+template <class T, std::size_t Align>
+struct AlignedAllocator {
+	typedef T value_type;
+
+	template <class U> struct rebind { typedef AlignedAllocator<U, Align> other; };
+
+	AlignedAllocator() {}
+	template <class U> AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+	T* allocate(std::size_t n) {
+		void *p;
+		if (posix_memalign(&p, Align, n*sizeof(T)) != 0) throw std::bad_alloc();
+		return static_cast<T*>(p);
+	}
+
+	void deallocate(T* p, std::size_t) {
+		free(p);
+	}
+};
+
+template <class T, class U, std::size_t Align>
+bool operator==(const AlignedAllocator<T, Align>&, const AlignedAllocator<U, Align>&) { return true; }
+
+template <class T, class U, std::size_t Align>
+bool operator!=(const AlignedAllocator<T, Align>&, const AlignedAllocator<U, Align>&) { return false; }
+
+
+/** A set of points, stored as a structure of arrays
+ *
+ * The x, y, z coordinates (and optionally weights) are held in separate,
+ * cache line aligned arrays, so that kernels can stream through them.
+ * If the set is unweighted, every point has unit weight.
+ */
+class PointSet {
+public :
+	/// Cache line aligned vector type
+	typedef std::vector<double, AlignedAllocator<double, 64> > Array;
+
+	/// Default constructor
+	PointSet() : weighted_(false) {};
+
+	/** Constructor
+	 *
+	 * @param npart (int) : number of points
+	 * @param weighted (bool) : store weights [false]
+	 */
+	PointSet(int npart, bool weighted=false);
+
+	/// Number of points
+	int size() const {return x_.size();}
+
+	/// Are weights stored?
+	bool weighted() const {return weighted_;}
+
+	/** Resize
+	 *
+	 * @param npart (int) : number of points
+	 */
+	void resize(int npart);
+
+	/// Pointers to the coordinate arrays
+	const double* x() const {return x_.data();}
+	const double* y() const {return y_.data();}
+	const double* z() const {return z_.data();}
+
+	/// Pointer to the weights; NULL if the set is unweighted
+	const double* w() const {return weighted_ ? w_.data() : NULL;}
+
+	/** Position of the ii'th point
+	 *
+	 * @param ii (int) : index
+	 */
+	Eigen::Vector3d pos(int ii) const {
+		return Eigen::Vector3d(x_[ii], y_[ii], z_[ii]);
+	}
+
+	/** Weight of the ii'th point
+	 *
+	 * @param ii (int) : index
+	 */
+	double weight(int ii) const {
+		return weighted_ ? w_[ii] : 1.0;
+	}
+
+	/** Set the ii'th point
+	 *
+	 * @param ii (int) : index
+	 * @param p (Vector3d) : position
+	 * @param w (double) : weight, ignored if the set is unweighted [1]
+	 */
+	void set(int ii, const Eigen::Vector3d& p, double w=1.0) {
+		x_[ii] = p[0]; y_[ii] = p[1]; z_[ii] = p[2];
+		if (weighted_) w_[ii] = w;
+	}
+
+	/** Reorder the points
+	 *
+	 * After this, the ii'th point is the old order[ii]'th point.
+	 *
+	 * @param order (vector<int>) : permutation
+	 */
+	void permute(const std::vector<int>& order);
+
+	/** Sort the points along a Morton (Z-order) curve
+	 *
+	 * Points close in space end up close in memory. The key uses 21 bits
+	 * per dimension over the bounding box of the points.
+	 */
+	void mortonSort();
+
+private :
+	Array x_, y_, z_, w_;
+	bool weighted_;
+};
+
+
+#endif /* NPPOINTSET_H_ */
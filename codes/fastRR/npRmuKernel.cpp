@@ -0,0 +1,144 @@
+/*
+ * npRmuKernel.cpp
+ *
+ *  Batched (r, mu) kernels. The vector kernels use the same sequence of
+ *  operations as compute_rmu, and no fused multiply-adds, so all the kernels
+ *  give bit for bit identical results.
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: npadmana
+ */
+
+#include <cmath>
+#include "npPairCount.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NP_RMU_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+const double eps=1.e-12; // Avoid divide by zero; must match compute_rmu
+
+typedef void (*RmuKernel)(const Eigen::Vector3d&, const double*, const double*, const double*,
+		int, double*, double*);
+
+void rmu_scalar(const Eigen::Vector3d& x, const double *bx, const double *by, const double *bz,
+		int n, double *rr, double *mu) {
+	for (int ii=0; ii < n; ++ii) {
+		double sx = x[0]-bx[ii], sy = x[1]-by[ii], sz = x[2]-bz[ii];
+		double lx = (x[0]+bx[ii])*0.5, ly = (x[1]+by[ii])*0.5, lz = (x[2]+bz[ii])*0.5;
+		double s2 = sx*sx + sy*sy + sz*sz;
+		double l2 = lx*lx + ly*ly + lz*lz;
+		double ls = lx*sx + ly*sy + lz*sz;
+		rr[ii] = sqrt(s2);
+		mu[ii] = ls/(sqrt(l2)*(rr[ii]+eps));
+	}
+}
+
+#ifdef NP_RMU_X86
+
+__attribute__((target("avx2")))
+void rmu_avx2(const Eigen::Vector3d& x, const double *bx, const double *by, const double *bz,
+		int n, double *rr, double *mu) {
+	const __m256d x0 = _mm256_set1_pd(x[0]), x1 = _mm256_set1_pd(x[1]), x2 = _mm256_set1_pd(x[2]);
+	const __m256d half = _mm256_set1_pd(0.5), veps = _mm256_set1_pd(eps);
+	int ii=0;
+	for (; ii+4 <= n; ii+=4) {
+		__m256d y0 = _mm256_loadu_pd(bx+ii), y1 = _mm256_loadu_pd(by+ii), y2 = _mm256_loadu_pd(bz+ii);
+		__m256d sx = _mm256_sub_pd(x0, y0), sy = _mm256_sub_pd(x1, y1), sz = _mm256_sub_pd(x2, y2);
+		__m256d lx = _mm256_mul_pd(_mm256_add_pd(x0, y0), half);
+		__m256d ly = _mm256_mul_pd(_mm256_add_pd(x1, y1), half);
+		__m256d lz = _mm256_mul_pd(_mm256_add_pd(x2, y2), half);
+		__m256d s2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(sx,sx), _mm256_mul_pd(sy,sy)), _mm256_mul_pd(sz,sz));
+		__m256d l2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(lx,lx), _mm256_mul_pd(ly,ly)), _mm256_mul_pd(lz,lz));
+		__m256d ls = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(lx,sx), _mm256_mul_pd(ly,sy)), _mm256_mul_pd(lz,sz));
+		__m256d r = _mm256_sqrt_pd(s2);
+		_mm256_storeu_pd(rr+ii, r);
+		_mm256_storeu_pd(mu+ii, _mm256_div_pd(ls, _mm256_mul_pd(_mm256_sqrt_pd(l2), _mm256_add_pd(r, veps))));
+	}
+	rmu_scalar(x, bx+ii, by+ii, bz+ii, n-ii, rr+ii, mu+ii);
+}
+
+__attribute__((target("avx512f")))
+void rmu_avx512(const Eigen::Vector3d& x, const double *bx, const double *by, const double *bz,
+		int n, double *rr, double *mu) {
+	const __m512d x0 = _mm512_set1_pd(x[0]), x1 = _mm512_set1_pd(x[1]), x2 = _mm512_set1_pd(x[2]);
+	const __m512d half = _mm512_set1_pd(0.5), veps = _mm512_set1_pd(eps);
+	int ii=0;
+	for (; ii+8 <= n; ii+=8) {
+		__m512d y0 = _mm512_loadu_pd(bx+ii), y1 = _mm512_loadu_pd(by+ii), y2 = _mm512_loadu_pd(bz+ii);
+		__m512d sx = _mm512_sub_pd(x0, y0), sy = _mm512_sub_pd(x1, y1), sz = _mm512_sub_pd(x2, y2);
+		__m512d lx = _mm512_mul_pd(_mm512_add_pd(x0, y0), half);
+		__m512d ly = _mm512_mul_pd(_mm512_add_pd(x1, y1), half);
+		__m512d lz = _mm512_mul_pd(_mm512_add_pd(x2, y2), half);
+		__m512d s2 = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(sx,sx), _mm512_mul_pd(sy,sy)), _mm512_mul_pd(sz,sz));
+		__m512d l2 = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(lx,lx), _mm512_mul_pd(ly,ly)), _mm512_mul_pd(lz,lz));
+		__m512d ls = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(lx,sx), _mm512_mul_pd(ly,sy)), _mm512_mul_pd(lz,sz));
+		__m512d r = _mm512_sqrt_pd(s2);
+		_mm512_storeu_pd(rr+ii, r);
+		_mm512_storeu_pd(mu+ii, _mm512_div_pd(ls, _mm512_mul_pd(_mm512_sqrt_pd(l2), _mm512_add_pd(r, veps))));
+	}
+	rmu_avx2(x, bx+ii, by+ii, bz+ii, n-ii, rr+ii, mu+ii);
+}
+
+#endif
+
+// Kernel choice
+struct KernelChoice {
+	RmuKernel func;
+	const char *name;
+};
+
+KernelChoice autoSelect() {
+#ifdef NP_RMU_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f")) return {rmu_avx512, "avx512"};
+	if (__builtin_cpu_supports("avx2")) return {rmu_avx2, "avx2"};
+#endif
+	return {rmu_scalar, "scalar"};
+}
+
+// Currently selected kernel, chosen at startup
+KernelChoice current = autoSelect();
+
+}
+
+void compute_rmu(const Eigen::Vector3d& x, const Eigen::Vector3d& y, double &rr, double &mu) {
+	rmu_scalar(x, &y[0], &y[1], &y[2], 1, &rr, &mu);
+}
+
+void compute_rmu_block(const Eigen::Vector3d& x, const double *bx, const double *by, const double *bz,
+		int n, double *rr, double *mu) {
+	current.func(x, bx, by, bz, n, rr, mu);
+}
+
+bool selectRmuKernel(const std::string& name) {
+	if (name == "auto") {
+		current = autoSelect();
+		return true;
+	}
+	if (name == "scalar") {
+		current = {rmu_scalar, "scalar"};
+		return true;
+	}
+#ifdef NP_RMU_X86
+	__builtin_cpu_init();
+	if ((name == "avx2") && __builtin_cpu_supports("avx2")) {
+		current = {rmu_avx2, "avx2"};
+		return true;
+	}
+	if ((name == "avx512") && __builtin_cpu_supports("avx512f")) {
+		current = {rmu_avx512, "avx512"};
+		return true;
+	}
+#endif
+	return false;
+}
+
+std::string rmuKernelName() {
+	return current.name;
+}
@@ -0,0 +1,108 @@
+/*
+ * npShellRR.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: npadmana
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "gsl/gsl_errno.h"
+#include "npgslAdapt.h"
+#include "npShellRR.h"
+
+using namespace std;
+
+namespace {
+
+// Range of L >= 0 with L^2 + a L + r^2/4 <= R^2; false if it is empty
+bool innerRange(double a, double r, double R, double& l1, double& l2) {
+	double disc = a*a - r*r + 4*R*R;
+	if (disc <= 0.0) return false;
+	double sq = sqrt(disc);
+	l1 = max(0.0, 0.5*(-a-sq));
+	l2 = 0.5*(-a+sq);
+	return l2 > l1;
+}
+
+// Ranges of L >= 0 with rmin^2 <= L^2 + a L + r^2/4 <= rmax^2. The
+// rmin range sits inside the rmax range, so there are at most two.
+int shellRange(double a, double r, double rmin, double rmax, double lo[2], double hi[2]) {
+	double o1, o2, i1, i2;
+	if (!innerRange(a, r, rmax, o1, o2)) return 0;
+	if (!innerRange(a, r, rmin, i1, i2)) {
+		lo[0] = o1; hi[0] = o2;
+		return 1;
+	}
+	int n = 0;
+	if (i1 > o1) { lo[n] = o1; hi[n] = i1; ++n; }
+	if (o2 > i2) { lo[n] = i2; hi[n] = o2; ++n; }
+	return n;
+}
+
+}
+
+ShellRR::ShellRR(double rmin, double rmax, double epsrel) :
+		rmin_(rmin), rmax_(rmax), epsrel_(epsrel), limit_(1000) {
+	double vol = 4*M_PI/3 * (pow(rmax,3) - pow(rmin,3));
+	norm_ = 8*M_PI*M_PI/(vol*vol);
+	wr_ = gsl_integration_workspace_alloc(limit_);
+	wmu_ = gsl_integration_workspace_alloc(limit_);
+}
+
+ShellRR::~ShellRR() {
+	gsl_integration_workspace_free(wr_);
+	gsl_integration_workspace_free(wmu_);
+}
+
+double ShellRR::lIntegral(double r, double mu) const {
+	// Both ends of the pair, l + s/2 and l - s/2, must be in the shell
+	double lo1[2], hi1[2], lo2[2], hi2[2];
+	int n1 = shellRange(r*mu, r, rmin_, rmax_, lo1, hi1);
+	int n2 = shellRange(-r*mu, r, rmin_, rmax_, lo2, hi2);
+
+	double sum = 0.0;
+	for (int ii=0; ii < n1; ++ii)
+		for (int jj=0; jj < n2; ++jj) {
+			double a = max(lo1[ii], lo2[jj]), b = min(hi1[ii], hi2[jj]);
+			if (b > a) sum += (b*b*b - a*a*a)/3;
+		}
+	return sum;
+}
+
+double ShellRR::density(double r, double mu) const {
+	return norm_ * r*r * lIntegral(r, mu);
+}
+
+int ShellRR::binFraction(double r0, double r1, double mu0, double mu1, double& frac, double& err) {
+	frac = 0.0; err = 0.0;
+	r0 = max(r0, 0.0); r1 = min(r1, 2*rmax_);
+	mu0 = max(mu0, -1.0); mu1 = min(mu1, 1.0);
+	if ((r1 <= r0) || (mu1 <= mu0)) return 0;
+
+	// Report failures through the return value, rather than aborting
+	gsl_error_handler_t *handler = gsl_set_error_handler_off();
+
+	int status = 0;
+	double rr;
+	auto fmu = [&](double mu) {
+		return lIntegral(rr, mu);
+	};
+	auto fr = [&](double r) {
+		double val, abserr;
+		rr = r;
+		gsl_function F = convertToGslFunction(fmu);
+		int stat = gsl_integration_qags(&F, mu0, mu1, 0.0, epsrel_, limit_, wmu_, &val, &abserr);
+		if (stat) status = stat;
+		return r*r*val;
+	};
+	gsl_function F = convertToGslFunction(fr);
+	int stat = gsl_integration_qags(&F, r0, r1, 0.0, epsrel_, limit_, wr_, &frac, &err);
+	if (stat) status = stat;
+
+	gsl_set_error_handler(handler);
+
+	frac *= norm_;
+	err *= norm_;
+	return status;
+}
@@ -0,0 +1,80 @@
+/*
+ * npShellRR.h
+ *
+ *  Semi-analytic RR(r, mu) for points uniformly distributed in a spherical shell.
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: npadmana
+ */
+
+#ifndef NPSHELLRR_H_
+#define NPSHELLRR_H_
+
+#include "gsl/gsl_integration.h"
+
+/** Pair density for points uniform in a shell rmin < |x| < rmax
+ *
+ * With s = x1-x2 and l = (x1+x2)/2, r = |s| and mu = l.s/(|l||s|), the
+ * probability that a random ordered pair lands in dr dmu is
+ *    8 pi^2 r^2 dr dmu / V^2 \int L^2 dL
+ * where the L = |l| integral runs over the L for which both |l +- s/2|
+ * lie in the shell. The L integral is done analytically, and the r and mu
+ * integrals by adaptive (QAGS) quadrature.
+ *
+ * The integration workspaces are held by the class, so an object must not be
+ * shared between threads.
+ */
+class ShellRR {
+public :
+	/** Constructor
+	 *
+	 * @param rmin (double) : inner radius of the shell
+	 * @param rmax (double) : outer radius of the shell
+	 * @param epsrel (double) : relative tolerance of the quadrature [1.e-6]
+	 */
+	ShellRR(double rmin, double rmax, double epsrel=1.e-6);
+
+	/// Destructor
+	~ShellRR();
+
+	ShellRR(const ShellRR&) = delete;
+	ShellRR& operator=(const ShellRR&) = delete;
+
+	/** \int L^2 dL over the allowed L, at fixed r, mu
+	 *
+	 * @param r (double) : separation
+	 * @param mu (double) : cosine of the angle between s and l
+	 */
+	double lIntegral(double r, double mu) const;
+
+	/** Probability density of a random ordered pair at (r, mu)
+	 *
+	 * This integrates to 1 over 0 < r < 2 rmax, -1 < mu < 1.
+	 *
+	 * @param r (double) : separation
+	 * @param mu (double) : cosine of the angle between s and l
+	 */
+	double density(double r, double mu) const;
+
+	/** Fraction of ordered pairs in a bin
+	 *
+	 * The bin is clipped to the physical range 0 <= r <= 2 rmax, -1 <= mu <= 1.
+	 *
+	 * @param r0, r1 (double) : r range of the bin
+	 * @param mu0, mu1 (double) : mu range of the bin
+	 * @param frac (double) : returns the fraction of pairs
+	 * @param err (double) : returns the estimated absolute error on frac
+	 *
+	 * returns 0 on success, or the GSL error code if any of the quadratures
+	 * did not reach the requested tolerance.
+	 */
+	int binFraction(double r0, double r1, double mu0, double mu1, double& frac, double& err);
+
+private :
+	double rmin_, rmax_, epsrel_, norm_;
+	size_t limit_;
+	gsl_integration_workspace *wr_, *wmu_;
+};
+
+
+#endif /* NPSHELLRR_H_ */
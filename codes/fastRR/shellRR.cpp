@@ -1,6 +1,38 @@
 /* Code for generating random points in a shell, and the calculating RR for
  * them.
  *
+ * Alternatively, if a data and random catalogue are specified, this computes
+ * the weighted DD, DR and RR pair counts for them in one pass. The catalogues
+ * are text files (optionally gzipped) with columns x y z [w]; if the weight
+ * is missing, it is set to 1. The work is split across ranks and threads as
+ * below.
+ *
+ * The realisations are spread across MPI ranks; if there are fewer
+ * realisations than ranks, every rank works on every realisation, and
+ * the pair counting is split between them. Run as
+ *   mpirun -np <nproc> shellRR --config shellRR.cfg
+ *
+ * For long runs, --checkpoint makes each rank periodically save its partial
+ * histogram and the blocks it has completed (each realisation is split into
+ * --nblocks blocks). Rerunning with --resume picks up from the last checkpoint;
+ * this needs the same parameters and number of ranks.
+ *
+ * For the shell, --method analytic instead computes RR by quadrature of the
+ * semi-analytic pair density (see npShellRR.h), scaled to nR(nR-1) ordered
+ * pairs, plus the self pairs if they are counted. Only if the quadrature
+ * fails in some bins are the Monte Carlo pairs counted (on the grid), and
+ * used for those bins. With --compare, the Monte Carlo is always run, and
+ * both are output, with a summary of the differences.
+ *
+ * The output is a text table by default. With --format binary, the output is
+ * instead written in one block, with everything little-endian :
+ *   char[8] "NPRMUHST"
+ *   int32 version (=1), nhist, nr, nmu
+ *   double redges[nr+1], muedges[nmu+1]
+ *   double counts[nhist][nr][nmu]
+ * where nhist is 1 for shell runs (2, RR and RR_MC, for analytic runs that
+ * also ran the Monte Carlo), and 3 (DD, DR, RR) for catalogue runs.
+ *
  */
 
 #include <iostream>
@@ -8,13 +40,24 @@
 #include <tuple>
 #include <string>
 #include <fstream>
+#include <memory>
 #include <Eigen/Core>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include "mpi.h"
 #include "boost/program_options.hpp"
 #include "boost/format.hpp"
 
 #include "npRandom.h"
 #include "npHistogram2D.h"
+#include "npHistogram2DMPI.h"
+#include "npTextFile.h"
+#include "npPairCount.h"
+#include "npShellRR.h"
 
 using namespace std;
 using namespace Eigen;
@@ -22,11 +65,10 @@ using boost::format;
 
 namespace po = boost::program_options;
 
-typedef vector<Vector3d> Pos;
 typedef tuple<double, double> paird;
 
-Pos generate(int npart, double rmin, double rmax, unsigned long int seed) {
-	Pos out;
+PointSet generate(int npart, double rmin, double rmax, unsigned long int seed) {
+	PointSet out;
 
 	double x, dr3, rmin3, rr;
 	rmin3 = pow(rmin, 3);
@@ -36,29 +78,176 @@ Pos generate(int npart, double rmin, double rmax, unsigned long int seed) {
 	out.resize(npart);
 	for (int ii=0; ii < npart; ++ii) {
 		rr = cbrt(dr3*ran1() + rmin3);
-		out[ii] = rr*ran1.dir3d();
+		out.set(ii, rr*ran1.dir3d());
 	}
 
 	return out;
 }
 
-void compute_rmu(const Vector3d& x, const Vector3d& y, double &rr, double &mu) {
-	const double eps=1.e-12; // Avoid divide by zero
+PointSet readCatalogue(const string& fn) {
+	InputTextFile ifile(fn);
+	Lines lines = ifile.read();
 
-	Vector3d s, l;
-	s = x-y;
-	l = (x+y)/2.0;
-	rr = s.norm();
-	mu = l.dot(s)/(l.norm()*(rr+eps));
+	// The first line decides if the catalogue is weighted; every line must
+	// then have the same columns. Lines are counted after comments and
+	// blank lines are dropped.
+	bool weighted = (lines.size() > 0) && (lines[0].size() > 3);
+	size_t ncol = weighted ? 4 : 3;
+	PointSet out(lines.size(), weighted);
+	for (size_t ii=0; ii < lines.size(); ++ii) {
+		const OneLine &l = lines[ii];
+		if (l.size() < ncol)
+			throw runtime_error((format("%1%, data line %2% : expected %3% columns, found %4%") % fn % (ii+1) % ncol % l.size()).str());
+		try {
+			Vector3d p(stod(l[0]), stod(l[1]), stod(l[2]));
+			out.set(ii, p, weighted ? stod(l[3]) : 1.0);
+		}
+		catch (logic_error &e) {
+			throw runtime_error((format("%1%, data line %2% : not a number") % fn % (ii+1)).str());
+		}
+	}
+
+	return out;
 }
 
-int main(int argc, char** argv) {
+// Append the bytes of val to buf, in little-endian order
+template <class T>
+void appendLE(vector<char>& buf, T val) {
+	char bytes[sizeof(T)];
+	memcpy(bytes, &val, sizeof(T));
+	const uint16_t one = 1;
+	if (*reinterpret_cast<const char*>(&one) == 0) reverse(bytes, bytes+sizeof(T));
+	buf.insert(buf.end(), bytes, bytes+sizeof(T));
+}
+
+/** Write the histograms in binary, as a single block
+ *
+ * See the top of the file for the format.
+ *
+ * @param ofs (ofstream) : output stream, opened in binary mode
+ * @param h1 (Histogram2D) : histogram with the binning
+ * @param hsum (vector<vector<double> >) : counts for each histogram
+ */
+void writeBinary(ofstream& ofs, Histogram2D& h1, const vector<vector<double> >& hsum) {
+	int nx = get<0>(h1.nbins()), ny = get<1>(h1.nbins());
+	vector<char> buf;
+	buf.reserve(24 + 8*(nx+ny+2 + hsum.size()*nx*ny));
+
+	const char magic[8] = {'N','P','R','M','U','H','S','T'};
+	buf.insert(buf.end(), magic, magic+8);
+	appendLE<int32_t>(buf, 1);
+	appendLE<int32_t>(buf, hsum.size());
+	appendLE<int32_t>(buf, nx);
+	appendLE<int32_t>(buf, ny);
+	for (int ii=0; ii < nx; ++ii) appendLE(buf, get<0>(h1.xrange(ii)));
+	appendLE(buf, get<1>(h1.xrange(nx-1)));
+	for (int jj=0; jj < ny; ++jj) appendLE(buf, get<0>(h1.yrange(jj)));
+	appendLE(buf, get<1>(h1.yrange(ny-1)));
+	for (const vector<double> &hh : hsum)
+		for (double x : hh) appendLE(buf, x);
+
+	ofs.write(&buf[0], buf.size());
+}
+
+/** Write the histograms as a text table
+ *
+ * @param ofs (ofstream) : output stream
+ * @param h1 (Histogram2D) : histogram with the binning
+ * @param hsum (vector<vector<double> >) : counts for each histogram, one column each
+ * @param names (vector<string>) : column names, listed if there are several histograms
+ */
+void writeText(ofstream& ofs, Histogram2D& h1, const vector<vector<double> >& hsum,
+		const vector<string>& names) {
+	int nx = get<0>(h1.nbins()), ny = get<1>(h1.nbins());
+	if (hsum.size() > 1) {
+		ofs << "# Columns : ir imu rlo rhi mulo muhi";
+		for (const string &name : names) ofs << " " << name;
+		ofs << "\n";
+	}
+	format histprint("%5i %5i %9.3f %9.3f %7.4f %7.4f");
+	format countprint(" %20.2f");
+	vector<paird> xr(nx), yr(ny);
+	for (int ii=0; ii < nx; ++ii) xr[ii] = h1.xrange(ii);
+	for (int ii=0; ii < ny; ++ii) yr[ii] = h1.yrange(ii);
+	for (int ii=0; ii < nx; ++ii) {
+		for (int jj=0; jj < ny; ++jj) {
+			ofs << histprint % ii % jj % get<0>(xr[ii]) % get<1>(xr[ii])
+					% get<0>(yr[jj]) % get<1>(yr[jj]);
+			for (const vector<double> &hh : hsum) ofs << countprint % hh[ii*ny+jj];
+			ofs << "\n";
+		}
+	}
+}
+
+/** Write a checkpoint
+ *
+ * The checkpoint is written to a temporary file, and then renamed, so that
+ * a crash while writing leaves the previous checkpoint intact.
+ *
+ * @param fn (string) : checkpoint file name
+ * @param config (vector<double>) : parameters of the run
+ * @param isim, iblock (int) : the next block to be done
+ * @param h1 (Histogram2D) : partial histogram
+ *
+ * returns true on success
+ */
+bool writeCheckpoint(const string& fn, const vector<double>& config, int isim, int iblock, const Histogram2D& h1) {
+	string tmpfn = fn + ".tmp";
+	FILE *fp = fopen(tmpfn.c_str(), "wb");
+	if (fp == NULL) return false;
+
+	size_t nconfig = config.size();
+	int nconfig32 = nconfig;
+	int next[2] = {isim, iblock};
+	bool ok = (fwrite(&nconfig32, sizeof(int), 1, fp) == 1) &&
+			(fwrite(&config[0], sizeof(double), nconfig, fp) == nconfig) &&
+			(fwrite(next, sizeof(int), 2, fp) == 2) &&
+			(h1.fwrite(fp) == 0);
+	ok = (fclose(fp) == 0) && ok;
+
+	return ok && (rename(tmpfn.c_str(), fn.c_str()) == 0);
+}
+
+/** Read a checkpoint
+ *
+ * @param fn (string) : checkpoint file name
+ * @param config (vector<double>) : parameters of the run, must match the checkpoint
+ * @param isim, iblock (int) : returns the next block to be done
+ * @param h1 (Histogram2D) : returns the partial histogram
+ *
+ * returns 0 on success, -1 if there is no checkpoint, and 1 if the checkpoint
+ * is unreadable or does not match this run.
+ */
+int readCheckpoint(const string& fn, const vector<double>& config, int& isim, int& iblock, Histogram2D& h1) {
+	FILE *fp = fopen(fn.c_str(), "rb");
+	if (fp == NULL) return -1;
+
+	int nconfig32, next[2];
+	size_t nconfig = config.size();
+	vector<double> config1(nconfig);
+	bool ok = (fread(&nconfig32, sizeof(int), 1, fp) == 1) && (nconfig32 >= 0) && (static_cast<size_t>(nconfig32) == nconfig) &&
+			(fread(&config1[0], sizeof(double), nconfig, fp) == nconfig) && (config1 == config) &&
+			(fread(next, sizeof(int), 2, fp) == 2) &&
+			(h1.fread(fp) == 0);
+	fclose(fp);
+	if (!ok) return 1;
+
+	isim = next[0]; iblock = next[1];
+	return 0;
+}
 
+int runShellRR(int argc, char** argv) {
 
-	int nR, nrbins, nmubins, nsims;
+	int rank, size;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+	int nR, nrbins, nmubins, nsims, nthreads, nblocks;
 	unsigned long int seed;
-	double rmin, rmax, r0, r1, mu0, mu1;
-	string outfn;
+	double rmin, rmax, r0, r1, mu0, mu1, ckptinterval;
+	string outfn, outformat, method, kernel, datafn, randfn, ckptfn;
+	double epsrel;
+	bool symmetric, selfpairs, morton, resume, compare, logr;
 
 	// Get the input parameters -- pull them into their own scope
 	{
@@ -77,10 +266,26 @@ int main(int argc, char** argv) {
 	    				("mu0", po::value<double>(&mu0)->default_value(-1.0), "Minimum mu value for histogram")
 	    				("mu1", po::value<double>(&mu1)->default_value(1.0), "Maximum mu value for histogram")
 	    				("nrbins", po::value<int>(&nrbins)->default_value(30), "Number of r bins")
+	    				("logr", po::bool_switch(&logr), "Log-spaced r bins; needs r0 > 0")
 	    				("nmubins", po::value<int>(&nmubins)->default_value(200), "Number of mu bins")
 	    				("seed", po::value<unsigned long int>(&seed)->default_value(99), "Seed value")
 	    				("nsims", po::value<int>(&nsims)->default_value(1), "Number of simulations")
 	    				("output",po::value<string>(&outfn)->default_value("shellRR.out"), "Output file")
+	    				("format",po::value<string>(&outformat)->default_value("text"), "Output format [text, binary]")
+	    				("method",po::value<string>(&method)->default_value("grid"), "Pair counting method [grid, brute, analytic]")
+	    				("nthreads",po::value<int>(&nthreads)->default_value(1), "Number of threads")
+	    				("symmetric",po::value<bool>(&symmetric)->default_value(true), "Only count each pair once, and mirror mu")
+	    				("selfpairs",po::value<bool>(&selfpairs)->default_value(true), "Include self pairs in symmetric mode")
+	    				("morton",po::value<bool>(&morton)->default_value(true), "Sort points along a Morton curve")
+	    				("kernel",po::value<string>(&kernel)->default_value("auto"), "Grid (r, mu) kernel [auto, scalar, avx2, avx512]")
+	    				("data",po::value<string>(&datafn), "Data catalogue; if set, compute DD, DR and RR")
+	    				("randoms",po::value<string>(&randfn), "Random catalogue, for use with --data")
+	    				("checkpoint",po::value<string>(&ckptfn), "Checkpoint file prefix; if set, checkpoints are written")
+	    				("checkpoint_interval",po::value<double>(&ckptinterval)->default_value(600.0), "Seconds between checkpoints")
+	    				("nblocks",po::value<int>(&nblocks)->default_value(1), "Number of checkpoint blocks per realisation")
+	    				("resume",po::bool_switch(&resume), "Resume from the checkpoint, if one exists")
+	    				("epsrel",po::value<double>(&epsrel)->default_value(1.e-6), "Relative tolerance for --method analytic")
+	    				("compare",po::bool_switch(&compare), "With --method analytic, also run the Monte Carlo and compare")
 	    				;
 
 			po::variables_map vm;
@@ -88,7 +293,7 @@ int main(int argc, char** argv) {
 			po::notify(vm);
 
 			if (vm.count("help")) {
-				cout << desc << "\n";
+				if (rank==0) cout << desc << "\n";
 				return 1;
 			}
 
@@ -102,6 +307,41 @@ int main(int argc, char** argv) {
 				po::notify(vm);
 				ifs.close();
 			}
+
+			if ((outformat != "text") && (outformat != "binary")) {
+				cout << "Unknown output format " << outformat << endl;
+				return 1;
+			}
+
+			if ((method != "grid") && (method != "brute") && (method != "analytic")) {
+				cout << "Unknown pair counting method " << method << endl;
+				return 1;
+			}
+
+			if ((method == "analytic") && !datafn.empty()) {
+				cout << "--method analytic is only for the shell" << endl;
+				return 1;
+			}
+
+			if (logr && (r0 <= 0.0)) {
+				cout << "--logr needs r0 > 0" << endl;
+				return 1;
+			}
+
+			if (!datafn.empty() && randfn.empty()) {
+				cout << "A random catalogue is needed with --data" << endl;
+				return 1;
+			}
+
+			if (resume && ckptfn.empty()) {
+				cout << "--resume needs a --checkpoint file" << endl;
+				return 1;
+			}
+
+			if (!selectRmuKernel(kernel)) {
+				cout << "Kernel " << kernel << " is unknown or not supported on this CPU" << endl;
+				return 1;
+			}
 		}
 		catch (exception &e) {
 			cout << e.what() << "\n";
@@ -110,40 +350,234 @@ int main(int argc, char** argv) {
 
 	}
 
-	ofstream ofs(outfn);
-	if (!ofs) {
-		cout << "Unable to open output file\n";
-		return 1;
+	// Only rank 0 writes out
+	ofstream ofs;
+	int ok = 1;
+	if (rank==0) {
+		ofs.open(outfn, (outformat == "binary") ? (ios_base::out | ios_base::binary) : ios_base::out);
+		if (!ofs) {
+			cout << "Unable to open output file\n";
+			ok = 0;
+		}
+	}
+	if ((rank==0) && (outformat == "text")) {
+		if (datafn.empty()) {
+			ofs << format("# Using %1% random points from r=%2% to %3%\n") % nR % rmin % rmax;
+		} else {
+			ofs << format("# DD, DR and RR for data %1% and randoms %2%\n") % datafn % randfn;
+		}
+		ofs << format("# Histogramming r from %1% to %2% in %3% %4%bins\n") % r0 % r1 % nrbins % (logr ? "log " : "");
+		ofs << format("# Histogramming mu from %1% to %2% in %3% bins\n") % mu0 % mu1 % nmubins;
+		ofs << format("# Pairs counted using the %1% method on %2% ranks x %3% threads\n") % method % size % nthreads;
+		if (method == "analytic") ofs << format("# Quadrature relative tolerance %1%\n") % epsrel;
+		if (method != "brute") ofs << format("# Using the %1% (r, mu) kernel\n") % rmuKernelName();
+		if (symmetric) ofs << format("# Symmetric pair counting, self pairs %1%\n") % (selfpairs ? "included" : "excluded");
 	}
-	ofs << format("# Using %1% random points from r=%2% to %3%\n") % nR % rmin % rmax;
-	ofs << format("# Histogramming r from %1% to %2% in %3% bins\n") % r0 % r1 % nrbins;
-	ofs << format("# Histogramming mu from %1% to %2% in %3% bins\n") % mu0 % mu1 % nmubins;
-
-	// Now compute the histogram
-	Histogram2D h1(nrbins, r0, r1, nmubins, mu0, mu1);
-	double rr, mu;
-
-	for (int isim=0; isim < nsims; ++isim) {
-		Pos pp = generate(nR, rmin, rmax, seed+isim);
-		for (int ii=0; ii < nR; ++ii)
-			for (int jj=0; jj < nR; ++jj) {
-				compute_rmu(pp[ii], pp[jj], rr, mu);
-				h1.add(rr, mu);
+	MPI_Bcast(&ok, 1, MPI_INT, 0, MPI_COMM_WORLD);
+	if (!ok) return 1;
+
+	// Auto and cross pair counts, either with a grid or by brute force
+	auto countAuto = [&](const PointSet& pp, const PairGrid* grid, Histogram2D& h, int offset, int stride) {
+		if (grid == NULL) {
+			if (symmetric)
+				countPairsBruteSymmetric(pp, h, selfpairs, offset, stride);
+			else
+				countPairsBrute(pp, h, offset, stride);
+		} else {
+			if (symmetric)
+				grid->countPairsSymmetric(h, selfpairs, offset, stride);
+			else
+				grid->countPairs(h, offset, stride);
+		}
+	};
+	auto countCross = [&](const PointSet& p1, const PointSet& p2, const PairGrid* grid2,
+			Histogram2D& h, int offset, int stride) {
+		if (grid2 == NULL)
+			countPairsBruteCross(p1, p2, h, offset, stride);
+		else
+			grid2->countCrossPairs(p1, h, offset, stride);
+	};
+
+	// Now compute the histograms
+	HistAxis raxis(nrbins, r0, r1, logr ? HistAxis::Log : HistAxis::Linear);
+	Histogram2D h1(raxis, HistAxis(nmubins, mu0, mu1));
+	vector<Histogram2D> hists;
+	vector<double> rra;
+	vector<int> failed;
+
+	if (datafn.empty()) {
+		// Analytic RR; the bins are dealt out across the ranks
+		bool runmc = true;
+		if (method == "analytic") {
+			ShellRR shell(rmin, rmax, epsrel);
+			double npairs = double(nR)*(nR-1)*nsims;
+			vector<double> aloc(nrbins*nmubins, 0.0);
+			vector<int> floc(nrbins*nmubins, 0);
+			bool self = !symmetric || selfpairs;
+			for (int ib=rank; ib < nrbins*nmubins; ib+=size) {
+				paird xr = h1.xrange(ib/nmubins), yr = h1.yrange(ib%nmubins);
+				double frac, err;
+				floc[ib] = (shell.binFraction(get<0>(xr), get<1>(xr), get<0>(yr), get<1>(yr), frac, err) != 0);
+				aloc[ib] = npairs*frac;
+
+				// Self pairs have r = mu = 0
+				if (self && (get<0>(xr) <= 0.0) && (get<1>(xr) > 0.0) && (get<0>(yr) <= 0.0) && (get<1>(yr) > 0.0))
+					aloc[ib] += double(nR)*nsims;
+			}
+			rra.resize(nrbins*nmubins);
+			failed.resize(nrbins*nmubins);
+			MPI_Allreduce(&aloc[0], &rra[0], nrbins*nmubins, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+			MPI_Allreduce(&floc[0], &failed[0], nrbins*nmubins, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+			int nfailed = count(failed.begin(), failed.end(), 1);
+			if ((rank==0) && (nfailed > 0))
+				cout << format("Quadrature failed in %1% bins, falling back to Monte Carlo for them\n") % nfailed;
+			runmc = compare || (nfailed > 0);
+		}
+
+		if (runmc) {
+			// Deal out whole realisations if there are enough of them, otherwise
+			// split each realisation across all the ranks
+			bool splitsims = (nsims >= size);
+			int ipart = splitsims ? 0 : rank;
+			int npart = splitsims ? 1 : size;
+
+			// The checkpoints are per rank, and the first block not yet done
+			// is (startsim, startblock). The pairs in a block depend on the
+			// number of threads and the point order, so these must match too.
+			string ckptrank = (boost::format("%1%.%2%") % ckptfn % rank).str();
+			vector<double> config = {double(nR), rmin, rmax, r0, r1, mu0, mu1, double(nrbins), double(nmubins),
+					double(seed), double(nsims), double(nblocks), double(size), double(rank),
+					double(symmetric), double(selfpairs), double(method!="brute"), double(logr),
+					double(nthreads), double(morton)};
+			int startsim = 0, startblock = 0;
+			if (resume) {
+				int status = readCheckpoint(ckptrank, config, startsim, startblock, h1);
+				if (status > 0)
+					cout << "Checkpoint " << ckptrank << " is unreadable, or does not match this run\n";
+
+				// Every rank must stop if any one checkpoint is bad, else the
+				// others block in the reductions
+				int bad = (status > 0), anybad = 0;
+				MPI_Allreduce(&bad, &anybad, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+				if (anybad) return 1;
+				if (status == 0)
+					cout << format("Rank %1% resuming at realisation %2%, block %3%\n") % rank % startsim % startblock;
 			}
+			double tlast = MPI_Wtime();
+
+			for (int isim=startsim; isim < nsims; ++isim) {
+				if (splitsims && (isim%size != rank)) continue;
+
+				PointSet pp = generate(nR, rmin, rmax, seed+isim);
+				if (morton) pp.mortonSort();
+
+				// Pairs beyond r1 are never histogrammed, so prune them
+				unique_ptr<PairGrid> grid;
+				if (method != "brute") grid.reset(new PairGrid(pp, r1));
+				for (int iblock=(isim==startsim) ? startblock : 0; iblock < nblocks; ++iblock) {
+					countPairsThreaded(nthreads, h1, [&](Histogram2D& h, int offset, int stride) {
+						countAuto(pp, grid.get(), h, offset, stride);
+					}, ipart*nblocks + iblock, npart*nblocks);
+
+					if (!ckptfn.empty() && ((MPI_Wtime()-tlast) > ckptinterval)) {
+						if (!writeCheckpoint(ckptrank, config, isim, iblock+1, h1))
+							cout << "Warning : unable to write checkpoint " << ckptrank << endl;
+						tlast = MPI_Wtime();
+					}
+				}
+			}
+			if (!ckptfn.empty()) writeCheckpoint(ckptrank, config, nsims, 0, h1);
+			hists.push_back(h1);
+		}
+	} else {
+		PointSet dd, rr;
+		try {
+			dd = readCatalogue(datafn);
+			rr = readCatalogue(randfn);
+		}
+		catch (const char *e) {
+			cout << e;
+			return 1;
+		}
+		catch (exception &e) {
+			cout << "Error parsing catalogue : " << e.what() << endl;
+			return 1;
+		}
+		if (morton) {
+			dd.mortonSort();
+			rr.mortonSort();
+		}
+
+		// The grids are shared between the three counts
+		unique_ptr<PairGrid> gridD, gridR;
+		if (method == "grid") {
+			gridD.reset(new PairGrid(dd, r1));
+			gridR.reset(new PairGrid(rr, r1));
+		}
+
+		hists.assign(3, h1);
+		countPairsThreaded(nthreads, hists[0], [&](Histogram2D& h, int offset, int stride) {
+			countAuto(dd, gridD.get(), h, offset, stride);
+		}, rank, size);
+		countPairsThreaded(nthreads, hists[1], [&](Histogram2D& h, int offset, int stride) {
+			countCross(dd, rr, gridR.get(), h, offset, stride);
+		}, rank, size);
+		countPairsThreaded(nthreads, hists[2], [&](Histogram2D& h, int offset, int stride) {
+			countAuto(rr, gridR.get(), h, offset, stride);
+		}, rank, size);
 	}
 
-	// Print out histogram
-	format histprint("%5i %5i %9.3f %9.3f %7.4f %7.4f %20.2f\n");
-	vector<paird> xr(nrbins), yr(nmubins);
-	for (int ii=0; ii < nrbins; ++ii) xr[ii] = h1.xrange(ii);
-	for (int ii=0; ii < nmubins; ++ii) yr[ii] = h1.yrange(ii);
-	for (int ii=0; ii < nrbins; ++ii) {
-		for (int jj=0; jj < nmubins; ++jj) {
-			ofs << histprint % ii % jj % get<0>(xr[ii]) % get<1>(xr[ii])
-					% get<0>(yr[jj]) % get<1>(yr[jj]) % h1(ii,jj);
+	// Sum the histograms onto rank 0
+	vector<vector<double> > hsum(hists.size(), vector<double>(nrbins*nmubins));
+	for (size_t ih=0; ih < hists.size(); ++ih) {
+		Histogram2DMPI::reduce(hists[ih], 0, MPI_COMM_WORLD);
+		for (int ii=0; ii < nrbins; ++ii)
+			for (int jj=0; jj < nmubins; ++jj)
+				hsum[ih][ii*nmubins+jj] = hists[ih](ii,jj);
+	}
+	if (rank!=0) return 0;
+
+	vector<string> names = {"DD", "DR", "RR"};
+	if (method == "analytic") {
+		// Use the Monte Carlo where the quadrature failed, and report the differences
+		vector<double> rrhyb = rra;
+		names = {"RR"};
+		if (!hsum.empty()) {
+			const vector<double> &rrmc = hsum[0];
+			double dmax = 0.0, d2 = 0.0, suma = 0.0, summc = 0.0;
+			int nused = 0;
+			for (int ib=0; ib < nrbins*nmubins; ++ib) {
+				if (failed[ib]) rrhyb[ib] = rrmc[ib];
+				if (failed[ib] || (rra[ib] <= 0.0)) continue;
+				double dev = (rrmc[ib]-rra[ib])/sqrt(rra[ib]);
+				dmax = max(dmax, fabs(dev));
+				d2 += dev*dev;
+				suma += rra[ib]; summc += rrmc[ib];
+				nused++;
+			}
+			string report = (format("# Monte Carlo vs analytic over %1% bins : rms (MC-RR)/sqrt(RR) = %2$.3f, max = %3$.3f, sum MC/RR = %4$.6f\n")
+					% nused % sqrt(d2/max(nused,1)) % dmax % ((suma > 0.0) ? summc/suma : 0.0)).str();
+			cout << report;
+			if (outformat == "text") ofs << report;
+			names.push_back("RR_MC");
 		}
+		hsum.insert(hsum.begin(), rrhyb);
 	}
 
+	// Write out histograms
+	if (outformat == "binary")
+		writeBinary(ofs, h1, hsum);
+	else
+		writeText(ofs, h1, hsum, names);
+
 	ofs.close();
 
+	return 0;
+}
+
+int main(int argc, char** argv) {
+	MPI_Init(&argc, &argv);
+	int retval = runShellRR(argc, argv);
+	MPI_Finalize();
+	return retval;
 }
@@ -0,0 +1,109 @@
+/*
+ * npConcurrentHistogram2D.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: npadmana
+ */
+
+#include <new>
+#include <thread>
+#include "npConcurrentHistogram2D.h"
+
+namespace {
+
+// Lock-free atomic x += w
+void atomicAdd(std::atomic<double>& x, double w) {
+	double old = x.load(std::memory_order_relaxed);
+	while (!x.compare_exchange_weak(old, old+w, std::memory_order_relaxed));
+}
+
+// Threads are dealt shards round robin, in the order they first add
+std::atomic<unsigned> nextSlot(0);
+
+unsigned threadSlot() {
+	thread_local unsigned slot = nextSlot++;
+	return slot;
+}
+
+}
+
+ConcurrentHistogram2D::ConcurrentHistogram2D(int nx, double xmin, double xmax, int ny, double ymin,
+		double ymax, int nshards) : proto_(nx, xmin, xmax, ny, ymin, ymax) {
+	init(nshards);
+}
+
+ConcurrentHistogram2D::ConcurrentHistogram2D(const Histogram2D& h1, int nshards) : proto_(h1) {
+	init(nshards);
+}
+
+void ConcurrentHistogram2D::init(int nshards) {
+	proto_.reset();
+	nx_ = proto_.hist->nx;
+	ny_ = proto_.hist->ny;
+	xr_.assign(proto_.hist->xrange, proto_.hist->xrange + nx_+1);
+	yr_.assign(proto_.hist->yrange, proto_.hist->yrange + ny_+1);
+
+	if (nshards <= 0) nshards = std::thread::hardware_concurrency();
+	nshards_ = (nshards > 0) ? nshards : 1;
+
+	// Keep the shards on separate cache lines : each is a whole number of
+	// lines, and the first starts on a line
+	const size_t cacheline = 64;
+	const size_t perline = cacheline/sizeof(std::atomic<double>);
+	stride_ = ((nx_*ny_ + perline-1)/perline)*perline;
+	size_t nbins = nshards_*stride_;
+	void *p;
+	if (posix_memalign(&p, cacheline, nbins*sizeof(std::atomic<double>)) != 0) throw std::bad_alloc();
+	std::atomic<double> *b = static_cast<std::atomic<double>*>(p);
+	for (size_t ii=0; ii < nbins; ++ii) new (b+ii) std::atomic<double>(0.0);
+	bins_.reset(b);
+}
+
+std::tuple<int, int> ConcurrentHistogram2D::nbins() const {
+	return std::make_tuple(nx_, ny_);
+}
+
+void ConcurrentHistogram2D::reset() {
+	for (size_t ii=0; ii < nshards_*stride_; ++ii)
+		bins_[ii].store(0.0, std::memory_order_relaxed);
+}
+
+std::tuple<double, double> ConcurrentHistogram2D::xrange(int i) const {
+	return std::make_tuple(xr_[i], xr_[i+1]);
+}
+
+std::tuple<double, double> ConcurrentHistogram2D::yrange(int j) const {
+	return std::make_tuple(yr_[j], yr_[j+1]);
+}
+
+double ConcurrentHistogram2D::operator()(int i, int j) const {
+	double sum = 0.0;
+	for (int is=0; is < nshards_; ++is)
+		sum += bins_[is*stride_ + i*ny_ + j].load(std::memory_order_relaxed);
+	return sum;
+}
+
+void ConcurrentHistogram2D::add(double x, double y, double weight) {
+	int i, j;
+	if (!(proto_.xaxis().find(x, i) & proto_.yaxis().find(y, j))) return;
+	atomicAdd(bins_[(threadSlot()%nshards_)*stride_ + i*ny_ + j], weight);
+}
+
+void ConcurrentHistogram2D::add(const std::vector<double> &x, const std::vector<double> &y, double w) {
+	for (size_t ii=0; ii<x.size(); ++ii)
+		add(x[ii], y[ii], w);
+}
+
+void ConcurrentHistogram2D::add(const std::vector<double> &x, const std::vector<double> &y,
+		const std::vector<double> &w) {
+	for (size_t ii=0; ii<x.size(); ++ii)
+		add(x[ii], y[ii], w[ii]);
+}
+
+Histogram2D ConcurrentHistogram2D::histogram() const {
+	Histogram2D h1(proto_);
+	for (int ii=0; ii < nx_; ++ii)
+		for (int jj=0; jj < ny_; ++jj)
+			h1.hist->bin[ii*ny_ + jj] = (*this)(ii, jj);
+	return h1;
+}
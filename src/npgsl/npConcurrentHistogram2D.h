@@ -0,0 +1,146 @@
+/*
+ * npConcurrentHistogram2D.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: npadmana
+ */
+
+#ifndef NPCONCURRENTHISTOGRAM2D_H_
+#define NPCONCURRENTHISTOGRAM2D_H_
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <tuple>
+#include <vector>
+#include "npHistogram2D.h"
+
+/** A 2D histogram that many threads can fill at once
+ *
+ * This has the same add interface as Histogram2D, and the same binning
+ * (lower bin edges inclusive, upper exclusive). The bins are split into
+ * shards; each thread adds into one shard, using lock-free atomic adds,
+ * so threads sharing a shard are still safe. The shards are summed when
+ * the histogram is read. The bins are always doubles; the accumulation
+ * policies of npHistAccumulator.h are not available here.
+ *
+ * Reading (and reset) should only be done once the threads filling the
+ * histogram are done. Since the order of the additions depends on the
+ * thread scheduling, the sums may differ in the last bits between runs.
+ */
+class ConcurrentHistogram2D {
+public :
+	/** Constructor for uniform bins
+	 *
+	 * @param nx : Number of xbins
+	 * @param xmin : minimum value in x
+	 * @param xmax : maximum value in x
+	 * @param ny : Number of ybins
+	 * @param ymin : minimum value in y
+	 * @param ymax : maximum value in y
+	 * @param nshards : number of shards [0 = number of hardware threads]
+	 */
+	ConcurrentHistogram2D(int nx, double xmin, double xmax, int ny, double ymin, double ymax, int nshards=0);
+
+	/** Constructor with the binning of an existing histogram
+	 *
+	 * The contents of h1 are not copied; the histogram starts empty.
+	 *
+	 * @param h1 (const Histogram2D&) : histogram with the binning
+	 * @param nshards : number of shards [0 = number of hardware threads]
+	 */
+	ConcurrentHistogram2D(const Histogram2D& h1, int nshards=0);
+
+	ConcurrentHistogram2D(const ConcurrentHistogram2D&) = delete;
+	ConcurrentHistogram2D& operator= (const ConcurrentHistogram2D&) = delete;
+
+	/** Get the number of bins
+	 *
+	 * returns a std::tuple<int, int> with (nx, ny)
+	 */
+	std::tuple<int, int> nbins() const;
+
+	/// Number of shards
+	int nshards() const {return nshards_;}
+
+	/** Reset the bins
+	 *
+	 */
+	void reset();
+
+	/** Get range of the i'th bin in the x direction
+	 *
+	 *  @param i (int) : i'th bin
+	 *
+	 *  returns std::tuple<double, double>
+	 */
+	std::tuple<double, double> xrange(int i) const;
+
+	/** Get range of the j'th bin in the y direction
+	 *
+	 * @param j (int) : j'th bin
+	 *
+	 * returns std::tuple<double, double>
+	 */
+	std::tuple<double, double> yrange(int j) const;
+
+	/** Get the value in the i,j bin, summed over the shards
+	 *
+	 * @param i (int) : i bin
+	 * @param j (int) : j bin
+	 *
+	 * returns (double) bin contents
+	 */
+	double operator()(int i, int j) const;
+
+	/** Increment x,y with weight. Safe to call from many threads.
+	 *
+	 * If x,y not in histogram range, this is silently dropped.
+	 *
+	 * @param x (double) : xval
+	 * @param y (double) : yval
+	 * @param w (double) : weight [defaults to 1.0]
+	 */
+	void add(double x, double y, double weight=1.0);
+
+	/** Increment x,y with weight. Safe to call from many threads.
+	 *
+	 * This version assumes the same weight for everything.
+	 *
+	 * @param x (vector<double>) : xval
+	 * @param y (vector<double>) : yval
+	 * @param w (double) : weight [defaults to 1.0]
+	 */
+	void add(const std::vector<double> &x, const std::vector<double> &y, double w=1.0);
+
+	/** Increment x,y with weight. Safe to call from many threads.
+	 *
+	 * @param x (vector<double>) : xval
+	 * @param y (vector<double>) : yval
+	 * @param w (vector<double>) : weight
+	 */
+	void add(const std::vector<double> &x, const std::vector<double> &y, const std::vector<double> &w);
+
+	/** The shards summed into a Histogram2D
+	 *
+	 * returns Histogram2D
+	 */
+	Histogram2D histogram() const;
+
+private :
+	std::vector<double> xr_, yr_;  // Bin edges; the bins are found with the axes of proto_
+	int nx_, ny_, nshards_;
+	size_t stride_;  // Bins per shard, padded to a whole number of cache lines
+
+	// The bins are allocated with posix_memalign, aligned to a cache line
+	struct FreeBins {
+		void operator()(std::atomic<double> *p) const {free(p);}
+	};
+	std::unique_ptr<std::atomic<double>[], FreeBins> bins_;
+	Histogram2D proto_;  // Empty histogram with the binning
+
+	void init(int nshards);
+};
+
+
+#endif /* NPCONCURRENTHISTOGRAM2D_H_ */
@@ -0,0 +1,81 @@
+/*
+ * npHistAccumulator.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: npadmana
+ */
+
+#ifndef NPHISTACCUMULATOR_H_
+#define NPHISTACCUMULATOR_H_
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+/** Accumulation policies for histogram bins
+ *
+ * Each policy defines the type of a bin (value_type), and how weights are
+ * added into it. A policy has
+ *     add(b, w)       : add weight w into bin b
+ *     increment(b)    : add unit weight into bin b
+ *     merge(b, b1)    : add bin b1 into bin b
+ *     value(b)        : the bin contents, as a double
+ * A default constructed value_type is an empty bin.
+ *
+ * The policies are only available on UniformHistogram2D and HistogramND.
+ * Histogram2D (backed by gsl_histogram2d) and ConcurrentHistogram2D (atomic
+ * adds) always accumulate plain doubles.
+ */
+
+/// Plain double precision sums
+struct DoubleAccumulator {
+	typedef double value_type;
+	static void add(value_type& b, double w) {b += w;}
+	static void increment(value_type& b) {b += 1.0;}
+	static void merge(value_type& b, const value_type& b1) {b += b1;}
+	static double value(const value_type& b) {return b;}
+};
+
+/** Compensated (Kahan-Babuska/Neumaier) double precision sums
+ *
+ * Each bin carries a running correction for the low order bits lost from
+ * the sum, so large totals of small weights stay accurate to roundoff. This
+ * doubles the storage, and costs a few extra flops per add.
+ */
+struct KahanAccumulator {
+	struct value_type {
+		double sum, c;
+		value_type() : sum(0.0), c(0.0) {};
+	};
+	static void add(value_type& b, double w) {
+		double t = b.sum + w;
+		b.c += (fabs(b.sum) >= fabs(w)) ? (b.sum - t) + w : (w - t) + b.sum;
+		b.sum = t;
+	}
+	static void increment(value_type& b) {add(b, 1.0);}
+	static void merge(value_type& b, const value_type& b1) {
+		add(b, b1.sum);
+		b.c += b1.c;
+	}
+	static double value(const value_type& b) {return b.sum + b.c;}
+};
+
+/** Integer counts
+ *
+ * For unweighted data. Weights must be non-negative integers, or omitted;
+ * other weights throw std::invalid_argument. Counts are exact up to 2^64.
+ */
+struct CountAccumulator {
+	typedef uint64_t value_type;
+	static void add(value_type& b, double w) {
+		if (!((w >= 0.0) && (w == floor(w)) && (w < 18446744073709551616.0)))
+			throw std::invalid_argument("CountAccumulator weights must be non-negative integers");
+		b += static_cast<uint64_t>(w);
+	}
+	static void increment(value_type& b) {++b;}
+	static void merge(value_type& b, const value_type& b1) {b += b1;}
+	static double value(const value_type& b) {return static_cast<double>(b);}
+};
+
+
+#endif /* NPHISTACCUMULATOR_H_ */
@@ -0,0 +1,82 @@
+/*
+ * npHistAxis.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: npadmana
+ */
+
+#include "npHistAxis.h"
+
+HistAxis::HistAxis(int n, double xmin, double xmax, Scale scale) : n_(n), scale_(scale), edges_(n+1), nlut_(0) {
+	if (scale == Log) {
+		if (xmin <= 0.0) throw "Log histogram axes need xmin > 0";
+		x0_ = log(xmin);
+		dx_ = n/(log(xmax) - x0_);
+		for (int ii=1; ii < n; ++ii) edges_[ii] = exp(x0_ + ii/dx_);
+	} else {
+		scale_ = Linear;
+		x0_ = xmin;
+		dx_ = n/(xmax - xmin);
+		// Same edges as gsl_histogram_set_ranges_uniform
+		for (int ii=1; ii < n; ++ii) edges_[ii] = (double(n-ii)/n)*xmin + (double(ii)/n)*xmax;
+	}
+	edges_[0] = xmin;
+	edges_[n] = xmax;
+}
+
+HistAxis::HistAxis(const std::vector<double>& edges) : n_(edges.size()-1), scale_(Edges), edges_(edges) {
+	// Four cells per bin, on average
+	nlut_ = 4*n_;
+	x0_ = edges_[0];
+	dx_ = nlut_/(edges_[n_] - edges_[0]);
+	lut_.resize(nlut_);
+	int i = 0;
+	for (int ic=0; ic < nlut_; ++ic) {
+		double x = x0_ + ic/dx_;
+		while ((i < n_-1) && (x >= edges_[i+1])) ++i;
+		lut_[ic] = i;
+	}
+}
+
+HistAxis HistAxis::fromEdges(const std::vector<double>& edges) {
+	int n = edges.size()-1;
+	double xmin = edges[0], xmax = edges[n];
+	HistAxis lin(n, xmin, xmax, Linear);
+	if (lin.edges_ == edges) return lin;
+	if (xmin > 0.0) {
+		HistAxis lg(n, xmin, xmax, Log);
+		if (lg.edges_ == edges) return lg;
+	}
+	return HistAxis(edges);
+}
+
+void HistAxis::guess(const double *x, int n, int *ibin) const {
+	// Keep NaNs and out of range values from the int conversion
+	double lo = edges_[0], hi = edges_[n_], top = n_-1;
+	if (scale_ == Edges) {
+		for (int k=0; k < n; ++k) {
+			if (!((x[k] >= lo) & (x[k] < hi))) {
+				ibin[k] = -1;
+				continue;
+			}
+			int ic = static_cast<int>((x[k]-x0_)*dx_);
+			ibin[k] = lut_[(ic < nlut_) ? ic : nlut_-1];
+		}
+	} else if (scale_ == Log) {
+		for (int k=0; k < n; ++k) {
+			double u = (fastLog(x[k])-x0_)*dx_;
+			u = (u > 0.0) ? u : 0.0;
+			u = (u < top) ? u : top;
+			int i = static_cast<int>(u);
+			ibin[k] = ((x[k] >= lo) & (x[k] < hi)) ? i : -1;
+		}
+	} else {
+		for (int k=0; k < n; ++k) {
+			double u = (x[k]-x0_)*dx_;
+			u = (u > 0.0) ? u : 0.0;
+			u = (u < top) ? u : top;
+			int i = static_cast<int>(u);
+			ibin[k] = ((x[k] >= lo) & (x[k] < hi)) ? i : -1;
+		}
+	}
+}
@@ -0,0 +1,158 @@
+/*
+ * npHistAxis.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: npadmana
+ */
+
+#ifndef NPHISTAXIS_H_
+#define NPHISTAXIS_H_
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <vector>
+
+/** One axis of a histogram, with uniform, log-uniform or arbitrary bins
+ *
+ * As for GSL histograms, the lower limit of each bin is inclusive, and the
+ * upper limit is exclusive. The bin is found by a multiply and truncate
+ * (of log x, for log bins), and then checked against the stored edges, so
+ * points on an edge always fall in the bin above it. For arbitrary edges,
+ * the multiply and truncate indexes a lookup table of the first bin in each
+ * of a set of uniform cells, which is then stepped forward to the right bin.
+ */
+class HistAxis {
+public :
+	/// Bin spacing
+	enum Scale {Linear, Log, Edges};
+
+	/** Basic constructor class
+	 *
+	 */
+	HistAxis() : n_(0), scale_(Linear), x0_(0.0), dx_(1.0), nlut_(0) {};
+
+	/** Constructor
+	 *
+	 * @param n (int) : number of bins
+	 * @param xmin (double) : minimum value
+	 * @param xmax (double) : maximum value
+	 * @param scale (Scale) : Linear or Log spacing; xmin must be > 0 for Log [Linear]
+	 */
+	HistAxis(int n, double xmin, double xmax, Scale scale=Linear);
+
+	/** Constructor for arbitrary bins
+	 *
+	 * @param edges (vector<double>) : increasing bin edges, one more than the number of bins
+	 */
+	HistAxis(const std::vector<double>& edges);
+
+	/** Axis with the given bin edges
+	 *
+	 * If the edges are exactly those of a Linear or Log axis (e.g. read back
+	 * from a file), that axis is returned, so the bins are found without the
+	 * lookup table; otherwise this is an Edges axis.
+	 *
+	 * @param edges (vector<double>) : increasing bin edges, one more than the number of bins
+	 */
+	static HistAxis fromEdges(const std::vector<double>& edges);
+
+	/// Number of bins
+	int nbins() const {return n_;}
+
+	/// Bin spacing
+	Scale scale() const {return scale_;}
+
+	/** Get range of the i'th bin
+	 *
+	 *  Note the lower limit is inclusive, and the upper limit is exclusive.
+	 *
+	 *  @param i (int) : i'th bin
+	 *
+	 *  returns std::tuple<double, double>
+	 */
+	std::tuple<double, double> range(int i) const {
+		return std::make_tuple(edges_[i], edges_[i+1]);
+	}
+
+	/// Bin edges, nbins()+1 of them
+	const std::vector<double>& edges() const {return edges_;}
+
+	/** Find the bin containing x
+	 *
+	 * @param x (double) : value
+	 * @param i (int) : returns the bin
+	 *
+	 * returns false if x is out of range
+	 */
+	bool find(double x, int& i) const {
+		const double *e = edges_.data();
+		if (!((x >= e[0]) & (x < e[n_]))) return false;
+		if (scale_ == Edges) {
+			int ic = static_cast<int>((x - x0_)*dx_);
+			i = lut_[(ic < nlut_) ? ic : nlut_-1];
+		} else {
+			// fastLog may put values at the ends a bin or so out of range
+			double u = (((scale_ == Log) ? fastLog(x) : x) - x0_)*dx_;
+			i = static_cast<int>((u > 0.0) ? u : 0.0);
+			if (i > n_-1) i = n_-1;
+		}
+		i = correct(x, i);
+		return true;
+	}
+
+	/** Guess the bins for a block of values
+	 *
+	 * For uniform bins, this is a simple loop over the block, which the
+	 * compiler can vectorise; otherwise, this finds the bins. Each guess
+	 * must be passed through correct().
+	 *
+	 * @param x (const double*) : values
+	 * @param n (int) : number of values
+	 * @param ibin (int*) : returns the guesses, or -1 if out of range
+	 */
+	void guess(const double *x, int n, int *ibin) const;
+
+	/** Correct a guess for the bin containing x
+	 *
+	 * @param x (double) : value, which must be in range
+	 * @param i (int) : guess, which may be a bin or so out
+	 *
+	 * returns the bin
+	 */
+	int correct(double x, int i) const {
+		const double *e = edges_.data();
+		while (x < e[i]) --i;
+		while (x >= e[i+1]) ++i;
+		return i;
+	}
+
+	/** Approximate natural log, good to ~1e-5
+	 *
+	 * Only used for the first guess of the bin, so it need not be exact.
+	 * This is from the exponent, and a series in the mantissa; unlike log,
+	 * it vectorises. x must be positive and normal.
+	 */
+	static double fastLog(double x) {
+		uint64_t b;
+		memcpy(&b, &x, sizeof(double));
+		int32_t e = static_cast<int32_t>(b >> 52) - 1023;
+		b = (b & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL;
+		double m;
+		memcpy(&m, &b, sizeof(double));
+		double t = (m-1)/(m+1), t2 = t*t;
+		return e*0.6931471805599453 + 2*t*(1 + t2*(1.0/3 + t2*(0.2 + t2/7)));
+	}
+
+private :
+	int n_;
+	Scale scale_;
+	double x0_, dx_;  // Offset and inverse bin (or lookup cell) width, in log x for Log bins
+	std::vector<double> edges_;
+	int nlut_;
+	std::vector<int> lut_;  // For Edges, the bin containing the start of each cell
+};
+
+
+#endif /* NPHISTAXIS_H_ */
@@ -5,16 +5,53 @@
  *      Author: npadmana
  */
 
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <utility>
 #include "npHistogram2D.h"
 
+namespace {
+
+const int blocksize = 256;
+
+// Axis of the given scale with these edges; false if the edges are not
+// increasing, or are not those of the scale
+bool makeAxis(int64_t scale, const std::vector<double>& edges, HistAxis& axis) {
+	int n = edges.size()-1;
+	for (int ii=0; ii < n; ++ii)
+		if (!(edges[ii] < edges[ii+1])) return false;
+	if (scale == HistAxis::Edges) {
+		axis = HistAxis(edges);
+	} else if ((scale == HistAxis::Linear) || ((scale == HistAxis::Log) && (edges[0] > 0.0))) {
+		axis = HistAxis(n, edges[0], edges[n], static_cast<HistAxis::Scale>(scale));
+	} else {
+		return false;
+	}
+	return axis.edges() == edges;
+}
+
+}
 
 Histogram2D::Histogram2D(int nx, double xmin, double xmax, int ny, double ymin,
-		double ymax) {
+		double ymax) : xaxis_(nx, xmin, xmax), yaxis_(ny, ymin, ymax) {
 	hist = gsl_histogram2d_alloc(nx, ny);
 	gsl_histogram2d_set_ranges_uniform(hist, xmin, xmax, ymin, ymax);
 
 }
 
+Histogram2D::Histogram2D(const HistAxis& xaxis, const HistAxis& yaxis) : xaxis_(xaxis), yaxis_(yaxis) {
+	hist = gsl_histogram2d_alloc(xaxis.nbins(), yaxis.nbins());
+	gsl_histogram2d_set_ranges(hist, xaxis.edges().data(), xaxis.nbins()+1,
+			yaxis.edges().data(), yaxis.nbins()+1);
+}
+
+Histogram2D::Histogram2D(const std::vector<double>& xedges, const std::vector<double>& yedges) :
+		Histogram2D(HistAxis(xedges), HistAxis(yedges)) {
+}
+
 Histogram2D::~Histogram2D() {
 	if (hist != NULL) gsl_histogram2d_free(hist);
 }
@@ -44,16 +81,47 @@ double Histogram2D::operator()(int i, int j) {
 }
 
 void Histogram2D::add(double x, double y, double weight) {
-	gsl_histogram2d_accumulate(hist, x, y, weight);
+	int i, j;
+	if (xaxis_.find(x, i) & yaxis_.find(y, j)) hist->bin[i*hist->ny + j] += weight;
 }
 
 void Histogram2D::add(const std::vector<double> &x, const std::vector<double> &y, double w) {
-	for (int ii=0; ii<x.size(); ++ii)
-		add(x[ii], y[ii], w);
+	addBlock(x.data(), y.data(), NULL, w, x.size());
+}
+
+void Histogram2D::add(const double *x, const double *y, const double *w, size_t n) {
+	assert(w != NULL);
+	addBlock(x, y, w, 1.0, n);
 }
 
-Histogram2D::Histogram2D(const Histogram2D& h1) {
-	hist =  gsl_histogram2d_clone(h1.hist);
+void Histogram2D::add(const double *x, const double *y, size_t n) {
+	addBlock(x, y, NULL, 1.0, n);
+}
+
+void Histogram2D::addConstant(const double *x, const double *y, size_t n, double w) {
+	addBlock(x, y, NULL, w, n);
+}
+
+void Histogram2D::addBlock(const double *x, const double *y, const double *w, double w0, size_t n) {
+	int ny = hist->ny;
+	int ix[blocksize], iy[blocksize];
+	for (size_t k0=0; k0 < n; k0+=blocksize) {
+		int nk = std::min<size_t>(blocksize, n-k0);
+		xaxis_.guess(x+k0, nk, ix);
+		yaxis_.guess(y+k0, nk, iy);
+
+		// The bins are incremented in order, as adding one at a time would
+		for (int k=0; k < nk; ++k) {
+			if ((ix[k] < 0) | (iy[k] < 0)) continue;
+			int i = xaxis_.correct(x[k0+k], ix[k]);
+			int j = yaxis_.correct(y[k0+k], iy[k]);
+			hist->bin[i*ny + j] += (w == NULL) ? w0 : w[k0+k];
+		}
+	}
+}
+
+Histogram2D::Histogram2D(const Histogram2D& h1) : xaxis_(h1.xaxis_), yaxis_(h1.yaxis_) {
+	hist = (h1.hist == NULL) ? NULL : gsl_histogram2d_clone(h1.hist);
 }
 
 Histogram2D& Histogram2D::operator =(const Histogram2D& h1) {
@@ -62,18 +130,114 @@ Histogram2D& Histogram2D::operator =(const Histogram2D& h1) {
 	}
 
 	if (hist!=NULL) gsl_histogram2d_free(hist);
-	hist =  gsl_histogram2d_clone(h1.hist);
+	hist = (h1.hist == NULL) ? NULL : gsl_histogram2d_clone(h1.hist);
+	xaxis_ = h1.xaxis_;
+	yaxis_ = h1.yaxis_;
+
+	return *this;
+}
+
+Histogram2D::Histogram2D(Histogram2D&& h1) noexcept :
+		hist(h1.hist), xaxis_(std::move(h1.xaxis_)), yaxis_(std::move(h1.yaxis_)) {
+	h1.hist = NULL;
+}
+
+Histogram2D& Histogram2D::operator =(Histogram2D&& h1) noexcept {
+	if (this == &h1) {
+		return *this;
+	}
+
+	if (hist!=NULL) gsl_histogram2d_free(hist);
+	hist = h1.hist;
+	h1.hist = NULL;
+	xaxis_ = std::move(h1.xaxis_);
+	yaxis_ = std::move(h1.yaxis_);
 
 	return *this;
 }
 
 void Histogram2D::add(const std::vector<double> &x, const std::vector<double> &y,
 		const std::vector<double> &w) {
-	for (int ii=0; ii<x.size(); ++ii)
-		add(x[ii], y[ii], w[ii]);
+	addBlock(x.data(), y.data(), w.data(), 1.0, x.size());
+}
+
+void Histogram2D::merge(const Histogram2D& h1) {
+	gsl_histogram2d_add(hist, h1.hist);
 }
 
+int Histogram2D::fwrite(FILE* stream) const {
+	return gsl_histogram2d_fwrite(stream, hist);
+}
+
+int Histogram2D::fread(FILE* stream) {
+	int status = gsl_histogram2d_fread(stream, hist);
+	xaxis_ = HistAxis::fromEdges(std::vector<double>(hist->xrange, hist->xrange + hist->nx+1));
+	yaxis_ = HistAxis::fromEdges(std::vector<double>(hist->yrange, hist->yrange + hist->ny+1));
+	return status;
+}
+
+size_t Histogram2D::serializedSize() const {
+	if (hist == NULL) return 4*sizeof(int64_t);
+	size_t nx = hist->nx, ny = hist->ny;
+	return 4*sizeof(int64_t) + (nx+1 + ny+1 + nx*ny)*sizeof(double);
+}
 
+void Histogram2D::serialize(void *buf) const {
+	char *p = static_cast<char*>(buf);
+	if (hist == NULL) {
+		int64_t head[4] = {0, 0, 0, 0};
+		memcpy(p, head, sizeof(head));
+		return;
+	}
+	int64_t head[4] = {static_cast<int64_t>(hist->nx), static_cast<int64_t>(hist->ny),
+			xaxis_.scale(), yaxis_.scale()};
+	size_t nx = hist->nx, ny = hist->ny;
+	memcpy(p, head, sizeof(head));
+	p += sizeof(head);
+	memcpy(p, hist->xrange, (nx+1)*sizeof(double));
+	p += (nx+1)*sizeof(double);
+	memcpy(p, hist->yrange, (ny+1)*sizeof(double));
+	p += (ny+1)*sizeof(double);
+	memcpy(p, hist->bin, nx*ny*sizeof(double));
+}
 
+std::vector<char> Histogram2D::serialize() const {
+	std::vector<char> buf(serializedSize());
+	serialize(buf.data());
+	return buf;
+}
 
+size_t Histogram2D::deserialize(const void *buf, size_t len) {
+	int64_t head[4];
+	const char *p = static_cast<const char*>(buf);
+	if (len < sizeof(head)) return 0;
+	memcpy(head, p, sizeof(head));
+	p += sizeof(head);
+
+	// An empty histogram
+	if ((head[0] == 0) && (head[1] == 0)) {
+		*this = Histogram2D();
+		return sizeof(head);
+	}
 
+	// Check the sizes against len before computing anything from them,
+	// so that a corrupt header cannot overflow
+	size_t ndouble = (len - sizeof(head))/sizeof(double);
+	if ((head[0] <= 0) || (head[1] <= 0) || (head[0] > INT_MAX) || (head[1] > INT_MAX)) return 0;
+	size_t nx = head[0], ny = head[1];
+	if ((nx >= ndouble) || (ny >= ndouble) || (nx+1 + ny+1 > ndouble)) return 0;
+	if (nx > (ndouble - (nx+1) - (ny+1))/ny) return 0;
+	size_t total = sizeof(head) + (nx+1 + ny+1 + nx*ny)*sizeof(double);
+
+	std::vector<double> xedges(nx+1), yedges(ny+1);
+	memcpy(xedges.data(), p, (nx+1)*sizeof(double));
+	p += (nx+1)*sizeof(double);
+	memcpy(yedges.data(), p, (ny+1)*sizeof(double));
+	p += (ny+1)*sizeof(double);
+	HistAxis xaxis, yaxis;
+	if (!makeAxis(head[2], xedges, xaxis) || !makeAxis(head[3], yedges, yaxis)) return 0;
+	*this = Histogram2D(xaxis, yaxis);
+	memcpy(hist->bin, p, nx*ny*sizeof(double));
+
+	return total;
+}
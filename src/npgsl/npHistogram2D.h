@@ -10,14 +10,25 @@
 
 #include <tuple>
 #include <vector>
+#include <cstdio>
 #include "gsl/gsl_histogram2d.h"
+#include "npHistAxis.h"
 
 /** Wrapper around the GSL histogram 2D class
  *
+ * The bins may be uniform, log-uniform or arbitrary. Bins are found with
+ * HistAxis, in constant time, rather than by GSL's search.
  */
 class Histogram2D {
 private :
 	gsl_histogram2d *hist;
+	HistAxis xaxis_, yaxis_;
+	friend class ConcurrentHistogram2D;
+	friend class Histogram2DMPI;
+	template <class Accum> friend class BasicUniformHistogram2D;
+
+	// Add n points, with weights w (or weight w0 if w is NULL)
+	void addBlock(const double *x, const double *y, const double *w, double w0, size_t n);
 public:
 	/** Basic constructor class
 	 *
@@ -36,6 +47,23 @@ public:
 	 */
 	Histogram2D(int nx, double xmin, double xmax, int ny, double ymin, double ymax);
 
+	/** Constructor from two axes
+	 *
+	 * For example, log bins in x and uniform bins in y are
+	 *    Histogram2D(HistAxis(nx, xmin, xmax, HistAxis::Log), HistAxis(ny, ymin, ymax))
+	 *
+	 * @param xaxis (HistAxis) : x bins
+	 * @param yaxis (HistAxis) : y bins
+	 */
+	Histogram2D(const HistAxis& xaxis, const HistAxis& yaxis);
+
+	/** Constructor for arbitrary bins
+	 *
+	 * @param xedges (vector<double>) : increasing x bin edges
+	 * @param yedges (vector<double>) : increasing y bin edges
+	 */
+	Histogram2D(const std::vector<double>& xedges, const std::vector<double>& yedges);
+
 	/** Copy constructor
 	 *
 	 * @param hist (const Histogram2D&)
@@ -48,6 +76,22 @@ public:
 	 */
 	Histogram2D& operator= (const Histogram2D &h1);
 
+	/** Move constructor
+	 *
+	 * h1 is left empty, as if default constructed.
+	 *
+	 * @param hist (Histogram2D&&)
+	 */
+	Histogram2D(Histogram2D &&h1) noexcept;
+
+	/** Move assignment operator
+	 *
+	 * h1 is left empty, as if default constructed.
+	 *
+	 * @param hist (Histogram2D&&)
+	 */
+	Histogram2D& operator= (Histogram2D &&h1) noexcept;
+
 
 	/** Destructor
 	 */
@@ -59,6 +103,12 @@ public:
 	 */
 	std::tuple<int, int> nbins();
 
+	/// The x axis
+	const HistAxis& xaxis() const {return xaxis_;}
+
+	/// The y axis
+	const HistAxis& yaxis() const {return yaxis_;}
+
 
 	/** Reset the bins
 	 *
@@ -130,6 +180,108 @@ public:
 	 */
 	void add(const std::vector<double> &x, const std::vector<double> &y, const std::vector<double> &w);
 
+	/** Increment x,y with weight, for n points.
+	 *
+	 * If x,y not in histogram range, this is silently dropped.
+	 * The bins are found a block at a time, and then incremented in
+	 * order, so the result is identical to adding the points one by one.
+	 *
+	 * @param x (const double*) : xval
+	 * @param y (const double*) : yval
+	 * @param w (const double*) : weight for each point
+	 * @param n (size_t) : number of points
+	 */
+	void add(const double *x, const double *y, const double *w, size_t n);
+
+	/** Increment x,y with unit weight, for n points.
+	 *
+	 * As above, with all the weights 1.
+	 *
+	 * @param x (const double*) : xval
+	 * @param y (const double*) : yval
+	 * @param n (size_t) : number of points
+	 */
+	void add(const double *x, const double *y, size_t n);
+
+	/** Increment x,y with the same weight, for n points.
+	 *
+	 * As above, with all the weights w.
+	 *
+	 * @param x (const double*) : xval
+	 * @param y (const double*) : yval
+	 * @param n (size_t) : number of points
+	 * @param w (double) : weight
+	 */
+	void addConstant(const double *x, const double *y, size_t n, double w);
+
+	/** Add the contents of another histogram into this one
+	 *
+	 * The two histograms must have identical binning.
+	 *
+	 * @param h1 (const Histogram2D&) : histogram to add in
+	 */
+	void merge(const Histogram2D &h1);
+
+	/** Write the histogram (ranges and bins) to a binary stream
+	 *
+	 * The data are written in the native binary format, so may not be
+	 * portable between architectures.
+	 *
+	 * @param stream (FILE*) : stream to write to
+	 *
+	 * returns 0 on success, a GSL error code otherwise
+	 */
+	int fwrite(FILE *stream) const;
+
+	/** Read the histogram (ranges and bins) from a binary stream
+	 *
+	 * The histogram must already have been allocated with the correct
+	 * number of bins; the ranges and bins are then overwritten. The axes
+	 * are rebuilt from the ranges with HistAxis::fromEdges, so Linear and
+	 * Log axes are restored as such.
+	 *
+	 * @param stream (FILE*) : stream to read from
+	 *
+	 * returns 0 on success, a GSL error code otherwise
+	 */
+	int fread(FILE *stream);
+
+	/** Size of the serialized histogram, in bytes
+	 *
+	 */
+	size_t serializedSize() const;
+
+	/** Serialize the histogram into one contiguous block
+	 *
+	 * The block is
+	 *   int64 nx, ny, xscale, yscale
+	 *   double xrange[nx+1], yrange[ny+1], bins[nx*ny]
+	 * in native byte order, with the bins in row-major order; the scales
+	 * are the HistAxis::Scale of each axis. An empty (default constructed or
+	 * moved from) histogram is just the header, with nx = ny = 0. This can
+	 * be written out, sent over MPI, or memory mapped as is.
+	 *
+	 * @param buf (void*) : buffer of at least serializedSize() bytes
+	 */
+	void serialize(void *buf) const;
+
+	/** Serialize the histogram into one contiguous block
+	 *
+	 * returns std::vector<char>, as above
+	 */
+	std::vector<char> serialize() const;
+
+	/** Replace this histogram with a serialized one
+	 *
+	 * The axes are rebuilt with their original scales.
+	 *
+	 * @param buf (const void*) : serialized histogram
+	 * @param len (size_t) : length of buf in bytes
+	 *
+	 * returns the number of bytes used, or 0 if buf is not a valid histogram
+	 */
+	size_t deserialize(const void *buf, size_t len);
+
 
 };
 
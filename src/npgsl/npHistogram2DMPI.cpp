@@ -0,0 +1,23 @@
+/*
+ * npHistogram2DMPI.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: npadmana
+ */
+
+#include "npHistogram2DMPI.h"
+
+int Histogram2DMPI::allreduce(Histogram2D& h1, MPI_Comm comm) {
+	gsl_histogram2d *hist = h1.hist;
+	return MPI_Allreduce(MPI_IN_PLACE, hist->bin, hist->nx*hist->ny, MPI_DOUBLE, MPI_SUM, comm);
+}
+
+int Histogram2DMPI::reduce(Histogram2D& h1, int root, MPI_Comm comm) {
+	gsl_histogram2d *hist = h1.hist;
+	int rank;
+	MPI_Comm_rank(comm, &rank);
+	int nbins = hist->nx*hist->ny;
+	if (rank == root)
+		return MPI_Reduce(MPI_IN_PLACE, hist->bin, nbins, MPI_DOUBLE, MPI_SUM, root, comm);
+	return MPI_Reduce(hist->bin, NULL, nbins, MPI_DOUBLE, MPI_SUM, root, comm);
+}
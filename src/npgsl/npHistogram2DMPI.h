@@ -0,0 +1,48 @@
+/*
+ * npHistogram2DMPI.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: npadmana
+ */
+
+#ifndef NPHISTOGRAM2DMPI_H_
+#define NPHISTOGRAM2DMPI_H_
+
+#include "mpi.h"
+#include "npHistogram2D.h"
+
+/** MPI reductions of Histogram2D
+ *
+ * These are kept out of Histogram2D, so that npgsl does not depend on MPI;
+ * they are in the separate npgslmpi library.
+ */
+class Histogram2DMPI {
+public :
+	/** Sum the histogram over all ranks, leaving the sum on every rank
+	 *
+	 * This is a single collective on the bins. The histograms must have
+	 * identical binning on all ranks.
+	 *
+	 * @param h1 (Histogram2D&) : histogram to sum
+	 * @param comm (MPI_Comm) : communicator [MPI_COMM_WORLD]
+	 *
+	 * returns the MPI error code
+	 */
+	static int allreduce(Histogram2D& h1, MPI_Comm comm=MPI_COMM_WORLD);
+
+	/** Sum the histogram over all ranks onto root
+	 *
+	 * This is a single collective on the bins. The histograms must have
+	 * identical binning on all ranks. The other ranks keep their own bins.
+	 *
+	 * @param h1 (Histogram2D&) : histogram to sum
+	 * @param root (int) : rank to sum onto
+	 * @param comm (MPI_Comm) : communicator [MPI_COMM_WORLD]
+	 *
+	 * returns the MPI error code
+	 */
+	static int reduce(Histogram2D& h1, int root, MPI_Comm comm=MPI_COMM_WORLD);
+};
+
+
+#endif /* NPHISTOGRAM2DMPI_H_ */
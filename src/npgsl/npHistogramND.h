@@ -0,0 +1,188 @@
+/*
+ * npHistogramND.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: npadmana
+ */
+
+#ifndef NPHISTOGRAMND_H_
+#define NPHISTOGRAMND_H_
+
+#include <algorithm>
+#include <array>
+#include <tuple>
+#include <vector>
+#include "npHistAxis.h"
+#include "npHistAccumulator.h"
+
+namespace npHistDetail {
+
+// Flat index of a point, computed over the axes D-1, D-2, ..., 0. The
+// recursion is resolved at compile time, so the loop is fully unrolled.
+template <int D>
+struct FlatIndex {
+	template <size_t N>
+	static bool get(const std::array<HistAxis, N>& axes, const double *x, size_t& idx) {
+		if (!FlatIndex<D-1>::get(axes, x, idx)) return false;
+		int i;
+		if (!axes[D-1].find(x[D-1], i)) return false;
+		idx = idx*axes[D-1].nbins() + i;
+		return true;
+	}
+};
+
+template <>
+struct FlatIndex<0> {
+	template <size_t N>
+	static bool get(const std::array<HistAxis, N>&, const double *, size_t& idx) {
+		idx = 0;
+		return true;
+	}
+};
+
+}
+
+/** An N dimensional histogram
+ *
+ * Each axis is a HistAxis, with uniform or log-uniform bins. The bins are
+ * stored contiguously in row-major order (the last index varies fastest).
+ * The interface follows Histogram2D : for example, a 2D histogram is
+ *     HistogramND<2> h1(HistAxis(nx, xmin, xmax), HistAxis(ny, ymin, ymax));
+ *     h1.add(x, y, w);
+ *     h1(i, j);
+ * The bins are accumulated according to Accum (see npHistAccumulator.h),
+ * plain doubles by default.
+ */
+template <int N, class Accum=DoubleAccumulator>
+class HistogramND {
+public :
+	/// Type of a bin
+	typedef typename Accum::value_type value_type;
+
+	/** Basic constructor class
+	 *
+	 */
+	HistogramND() {};
+
+	/** Constructor
+	 *
+	 * @param axes (array<HistAxis, N>) : the axes
+	 */
+	HistogramND(const std::array<HistAxis, N>& axes) : axes_(axes) {
+		size_t nbins = 1;
+		for (int ii=0; ii < N; ++ii) nbins *= axes_[ii].nbins();
+		bins_.assign(nbins, value_type());
+	}
+
+	/** Constructor
+	 *
+	 * @param axes (HistAxis...) : the N axes
+	 */
+	template <class... Axes>
+	HistogramND(const HistAxis& a0, const Axes&... axes) :
+		HistogramND(std::array<HistAxis, N>{{a0, axes...}}) {
+		static_assert(sizeof...(Axes)+1 == N, "HistogramND needs N axes");
+	}
+
+	/** Get the number of bins
+	 *
+	 * returns std::array<int, N>; std::get<0>() etc. work as for Histogram2D
+	 */
+	std::array<int, N> nbins() const {
+		std::array<int, N> out;
+		for (int ii=0; ii < N; ++ii) out[ii] = axes_[ii].nbins();
+		return out;
+	}
+
+	/// Axis idim
+	const HistAxis& axis(int idim) const {return axes_[idim];}
+
+	/** Reset the bins
+	 *
+	 */
+	void reset() {
+		std::fill(bins_.begin(), bins_.end(), value_type());
+	}
+
+	/** Get range of the i'th bin along axis idim
+	 *
+	 *  Note the lower limit is inclusive, and the upper limit is exclusive.
+	 *
+	 *  @param idim (int) : axis
+	 *  @param i (int) : i'th bin
+	 *
+	 *  returns std::tuple<double, double>
+	 */
+	std::tuple<double, double> range(int idim, int i) const {return axes_[idim].range(i);}
+
+	/// As for Histogram2D, ranges along the first, second and third axes
+	std::tuple<double, double> xrange(int i) const {return range(0, i);}
+	std::tuple<double, double> yrange(int i) const {return range(1, i);}
+	std::tuple<double, double> zrange(int i) const {return range(2, i);}
+
+	/** Get the value in a bin
+	 *
+	 * @param i (int...) : N bin indices
+	 *
+	 * returns (double) bin contents
+	 */
+	template <class... Idx>
+	double operator()(Idx... i) const {
+		static_assert(sizeof...(Idx) == N, "HistogramND needs N indices");
+		const int ii[N] = {static_cast<int>(i)...};
+		size_t idx = 0;
+		for (int idim=0; idim < N; ++idim) idx = idx*axes_[idim].nbins() + ii[idim];
+		return Accum::value(bins_[idx]);
+	}
+
+	/** Increment a point with weight
+	 *
+	 * If the point is not in the histogram range, this is silently dropped.
+	 *
+	 * @param x (array<double, N>) : the point
+	 * @param w (double) : weight [defaults to 1.0]
+	 */
+	void add(const std::array<double, N>& x, double weight=1.0) {
+		size_t idx;
+		if (npHistDetail::FlatIndex<N>::get(axes_, x.data(), idx)) Accum::add(bins_[idx], weight);
+	}
+
+	/** Increment a point with weight
+	 *
+	 * Called as add(x, y, ...) with N coordinates, optionally followed by
+	 * a weight [defaults to 1.0], as for Histogram2D.
+	 */
+	template <class... Args>
+	void add(double x0, Args... args) {
+		static_assert((sizeof...(Args)+1 == N) || (sizeof...(Args) == N), "HistogramND::add needs N coordinates, and an optional weight");
+		const double xw[] = {x0, static_cast<double>(args)..., 1.0};
+		size_t idx;
+		if (npHistDetail::FlatIndex<N>::get(axes_, xw, idx)) Accum::add(bins_[idx], xw[N]);
+	}
+
+	/** Add the contents of another histogram into this one
+	 *
+	 * The two histograms must have identical binning.
+	 *
+	 * @param h1 (const HistogramND&) : histogram to add in
+	 */
+	void merge(const HistogramND& h1) {
+		for (size_t ii=0; ii < bins_.size(); ++ii) Accum::merge(bins_[ii], h1.bins_[ii]);
+	}
+
+	/// Total number of bins
+	size_t size() const {return bins_.size();}
+
+	/// Pointer to the bins, in row-major order
+	const value_type* data() const {return bins_.data();}
+
+private :
+	std::array<HistAxis, N> axes_;
+	std::vector<value_type> bins_;
+};
+
+typedef HistogramND<1> Histogram1D;
+typedef HistogramND<3> Histogram3D;
+
+
+#endif /* NPHISTOGRAMND_H_ */
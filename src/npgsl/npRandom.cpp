@@ -8,11 +8,95 @@
 #include "npRandom.h"
 #include "gsl/gsl_randist.h"
 
+namespace {
+
+// Philox as a GSL generator, so the GSL distributions work with it. The
+// counter is (block, stream), and each block gives four 32 bit outputs.
+struct philox_state {
+	uint32_t key[2];
+	uint64_t stream;
+	uint64_t index;   // Next output
+	uint64_t block;   // Block in buf, or ~0
+	uint32_t buf[4];
+};
+
+void philox_fill(philox_state *st, uint64_t block) {
+	uint32_t ctr[4] = {static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32),
+			static_cast<uint32_t>(st->stream), static_cast<uint32_t>(st->stream >> 32)};
+	philox4x32(ctr, st->key, st->buf);
+	st->block = block;
+}
+
+void philox_set(void *vstate, unsigned long int seed) {
+	philox_state *st = static_cast<philox_state*>(vstate);
+	uint64_t s = seed;
+	st->key[0] = static_cast<uint32_t>(s);
+	st->key[1] = static_cast<uint32_t>(s >> 32);
+	st->stream = 0;
+	st->index = 0;
+	st->block = ~0ULL;
+}
+
+unsigned long int philox_get(void *vstate) {
+	philox_state *st = static_cast<philox_state*>(vstate);
+	uint64_t block = st->index >> 2;
+	if (block != st->block) philox_fill(st, block);
+	return st->buf[st->index++ & 3];
+}
+
+// 53 bits, from two outputs
+double philox_get_double(void *vstate) {
+	uint32_t a = philox_get(vstate) >> 5, b = philox_get(vstate) >> 6;
+	return (a*67108864.0 + b)*(1.0/9007199254740992.0);
+}
+
+const gsl_rng_type philox_type = {"philox4x32", 0xffffffffUL, 0, sizeof(philox_state),
+		&philox_set, &philox_get, &philox_get_double};
+
+}
+
+void philox4x32(const uint32_t ctr[4], const uint32_t key[2], uint32_t out[4]) {
+	const uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57, W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+	uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+	uint32_t k0 = key[0], k1 = key[1];
+	for (int ir=0; ir < 10; ++ir) {
+		uint64_t p0 = static_cast<uint64_t>(M0)*c0, p1 = static_cast<uint64_t>(M1)*c2;
+		uint32_t hi0 = p0 >> 32, lo0 = static_cast<uint32_t>(p0);
+		uint32_t hi1 = p1 >> 32, lo1 = static_cast<uint32_t>(p1);
+		c0 = hi1 ^ c1 ^ k0;
+		c1 = lo1;
+		c2 = hi0 ^ c3 ^ k1;
+		c3 = lo0;
+		k0 += W0;
+		k1 += W1;
+	}
+	out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+}
+
 npRandom::npRandom(unsigned long int seed) {
 	  ran = gsl_rng_alloc(gsl_rng_mt19937);
 	  gsl_rng_set(ran, seed);
 }
 
+npRandom::npRandom(unsigned long int seed, unsigned long int stream) {
+	ran = gsl_rng_alloc(&philox_type);
+	gsl_rng_set(ran, seed);
+	static_cast<philox_state*>(gsl_rng_state(ran))->stream = stream;
+}
+
+void npRandom::seek(uint64_t n) {
+	if (ran->type != &philox_type) throw "npRandom::seek needs a counter-based stream";
+	static_cast<philox_state*>(gsl_rng_state(ran))->index = 2*n;
+}
+
+double npRandom::uniform(unsigned long int seed, unsigned long int stream, uint64_t n) {
+	philox_state st;
+	philox_set(&st, seed);
+	st.stream = stream;
+	st.index = 2*n;
+	return philox_get_double(&st);
+}
+
 npRandom::~npRandom() {
 	gsl_rng_free(ran);
 }
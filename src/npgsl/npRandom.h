@@ -10,12 +10,32 @@
 
 #include <gsl/gsl_rng.h>
 #include <gsl/gsl_qrng.h>
+#include <cstdint>
 #include <vector>
 #include <Eigen/Core>
 
+/** The Philox4x32-10 counter-based generator
+ *
+ *  Salmon et al., "Parallel random numbers: as easy as 1, 2, 3" (SC11).
+ *  Encrypts a 128 bit counter with a 64 bit key; the outputs for
+ *  different counters are independent.
+ *
+ *  @param ctr (const uint32_t[4]) : counter
+ *  @param key (const uint32_t[2]) : key
+ *  @param out (uint32_t[4]) : returns the random output
+ */
+void philox4x32(const uint32_t ctr[4], const uint32_t key[2], uint32_t out[4]);
+
 /** Wrapper around the GSL random number generators
  *
- *  Automatically switches to using the Mersenne Twister
+ *  Automatically switches to using the Mersenne Twister, unless a stream
+ *  is specified.
+ *
+ *  With a stream, this uses a counter-based generator (Philox4x32-10).
+ *  Each (seed, stream) is an independent sequence, and the n'th number of
+ *  any sequence can be computed directly, so results need not depend on
+ *  how the work is split. For example, each rank or thread can take its
+ *  own stream, or all can share one stream and seek() to their own part.
  *
  *  NOTE : This class cannot be copied or assigned.
  */
@@ -28,6 +48,13 @@ public:
 	 */
 	npRandom(unsigned long int seed);
 
+	/** Constructor for a counter-based stream
+	 *
+	 * @param seed (unsigned long int)
+	 * @param stream (unsigned long int) : stream number, e.g. a rank or thread
+	 */
+	npRandom(unsigned long int seed, unsigned long int stream);
+
 	/// Destructor
 	~npRandom();
 
@@ -48,6 +75,26 @@ public:
 	 */
 	Eigen::Vector3d dir3d();
 
+	/** Jump to the n'th random number of a counter-based stream
+	 *
+	 * Each random number in [0,1) uses two 32 bit outputs, so this is
+	 * exact for streams drawn only through operator().
+	 * Throws if this is not a counter-based stream.
+	 *
+	 * @param n (uint64_t)
+	 */
+	void seek(uint64_t n);
+
+	/** The n'th random number in [0,1) of a counter-based stream
+	 *
+	 * Same as npRandom(seed, stream), seek(n), operator().
+	 *
+	 * @param seed (unsigned long int)
+	 * @param stream (unsigned long int)
+	 * @param n (uint64_t)
+	 */
+	static double uniform(unsigned long int seed, unsigned long int stream, uint64_t n);
+
 private :
 	// Disable copy and assignment
 	npRandom(const npRandom& x);
@@ -2,45 +2,82 @@
 
 using namespace std;
 
-Spline::Spline(const vector<double> x, const vector<double> y, const gsl_interp_type *sptype) {
-
-	// Cache vectors
-	_x = x; _y = y;
-	interptype = sptype;
-	init();
-};
-
-void Spline::init() {
+Spline::Table::Table(vector<double>&& x, vector<double>&& y, const gsl_interp_type *sptype) :
+		_x(std::move(x)), _y(std::move(y)) {
 	int n = _x.size();
 	// Set up the interpolation
-	acc = gsl_interp_accel_alloc();
-	sp = gsl_interp_alloc(interptype, n);
-	gsl_interp_init(sp, static_cast<double *>(&_x[0]), static_cast<double *>(&_y[0]), n);
+	sp = gsl_interp_alloc(sptype, n);
+	gsl_interp_init(sp, &_x[0], &_y[0], n);
 }
 
-// Now define the copy constructor and assignment operator
-Spline::Spline(const Spline& sp1) {
-	_x = sp1._x; _y = sp1._y; interptype = sp1.interptype;
-	init();
+Spline::Table::~Table() {
+	if (sp != NULL) gsl_interp_free(sp);
 }
 
+Spline::Spline(vector<double> x, vector<double> y, const gsl_interp_type *sptype) :
+		table(std::make_shared<Table>(std::move(x), std::move(y), sptype)), acc() {
+};
+
+// Now define the assignment operators
 Spline& Spline::operator=(const Spline& sp1) {
 	if (this == &sp1) {
 		return *this;
 	}
 
-	_x = sp1._x; _y = sp1._y; interptype = sp1.interptype;
-	init();
+	table = sp1.table;
+	acc = gsl_interp_accel();
 	return *this;
 }
 
+Spline& Spline::operator=(Spline&& sp1) noexcept {
+	table = std::move(sp1.table);
+	acc = sp1.acc;
+	return *this;
+}
 
-Spline::~Spline() {
-	if (acc != NULL) gsl_interp_accel_free(acc);
-	if (sp != NULL) gsl_interp_free(sp);
+double Spline::operator()(double x) {
+	return gsl_interp_eval(table->sp, &table->_x[0], &table->_y[0], x, &acc);
+}
 
+double Spline::eval(double x) const {
+	return gsl_interp_eval(table->sp, &table->_x[0], &table->_y[0], x, NULL);
 }
 
-double Spline::operator()(double x) {
-	return gsl_interp_eval(sp, static_cast<double *>(&_x[0]), static_cast<double *>(&_y[0]), x, acc);
+double Spline::eval(double x, gsl_interp_accel *a) const {
+	return gsl_interp_eval(table->sp, &table->_x[0], &table->_y[0], x, a);
+}
+
+void Spline::eval(const double *x, double *y, size_t n) const {
+	const gsl_interp *sp = table->sp;
+	const double *xa = &table->_x[0], *ya = &table->_y[0];
+	size_t nk = table->_x.size();
+	gsl_interp_accel acc = {0, 0, 0};
+
+	bool sorted = true;
+	for (size_t ii=1; (ii < n) && sorted; ++ii) sorted = (x[ii-1] <= x[ii]);
+	if (!sorted) {
+		for (size_t ii=0; ii < n; ++ii) y[ii] = gsl_interp_eval(sp, xa, ya, x[ii], &acc);
+		return;
+	}
+
+	// Sorted input : step forward through the knots, falling back to a
+	// search for large jumps, and set the accelerator so it always hits.
+	size_t i = 0;
+	for (size_t ii=0; ii < n; ++ii) {
+		int nstep = 0;
+		while ((i+2 < nk) && (x[ii] >= xa[i+1])) {
+			if (++nstep > 4) {
+				i = gsl_interp_bsearch(xa, x[ii], i, nk-1);
+				break;
+			}
+			++i;
+		}
+		acc.cache = i;
+		y[ii] = gsl_interp_eval(sp, xa, ya, x[ii], &acc);
+	}
+}
+
+double Spline::integral(double a, double b) const {
+	if (b < a) return -integral(b, a);
+	return gsl_interp_eval_integ(table->sp, &table->_x[0], &table->_y[0], a, b, NULL);
 }
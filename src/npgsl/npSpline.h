@@ -10,28 +10,44 @@
 
 #include <vector>
 #include <cstddef>
+#include <memory>
 #include <gsl/gsl_spline.h>
 #include <gsl/gsl_interp.h>
 
 /** \brief A basic wrapper around the GSL spline functions.
  *
+ *  operator() uses an accelerator shared by the object, and so may not be
+ *  called from several threads at once. The const eval functions keep their
+ *  lookup state per call, so a single Spline may be shared between threads.
+ *
+ *  The knots and the fit are immutable once constructed, and are shared by
+ *  reference count between copies, so copies are cheap and are not re-fit.
+ *  Each copy has its own accelerator.
  */
 class Spline {
 private :
-	// GSL members
-	gsl_interp * sp;
-	gsl_interp_accel * acc;
-	const gsl_interp_type *interptype;
+	// Knots and GSL fit, shared between copies
+	struct Table {
+		std::vector<double> _x, _y;
+		gsl_interp * sp;
 
-	// Cache x and y
-	std::vector<double> _x, _y;
+		Table(std::vector<double>&& x, std::vector<double>&& y, const gsl_interp_type *sptype);
+		~Table();
+		Table(const Table&) = delete;
+		Table& operator=(const Table&) = delete;
+	};
+	std::shared_ptr<const Table> table;
+	friend class SplineSampler;
 
-	// Helper initialization function
-	void init();
+	// Accelerator for operator()
+	gsl_interp_accel acc;
 public :
-	Spline() : sp(NULL), acc(NULL) {};
+	Spline() : acc() {};
 
 	/** Constructor.
+	 *
+	 *  The knots are moved into the spline when x and y are rvalues,
+	 *  e.g. Spline(std::move(x), std::move(y)), and copied otherwise.
 	 *
 	 *  @param x (vector<double>) -- the x parameter
 	 *  @param y (vector<double>) -- the y parameter
@@ -44,23 +60,67 @@ public :
 	 *           gsl_interp_akima
 	 *           gsl_interp_akima_periodic
 	 */
-	Spline(const std::vector<double> x, const std::vector<double> y,
+	Spline(std::vector<double> x, std::vector<double> y,
 			const gsl_interp_type *sptype = gsl_interp_cspline);
 
-	/// Destructor
-	~Spline();
+	/// Copy constructor; shares the table
+	Spline(const Spline& sp1) : table(sp1.table), acc() {};
 
-	/// Copy constructor
-	Spline(const Spline& sp1);
+	/// Move constructor
+	Spline(Spline&& sp1) noexcept : table(std::move(sp1.table)), acc(sp1.acc) {};
 
-	/// Assignment operator
+	/// Assignment operator; shares the table
 	Spline& operator=(const Spline& sp1);
 
+	/// Move assignment operator
+	Spline& operator=(Spline&& sp1) noexcept;
+
 	/** Evaluate the spline at x.
 	 *
 	 *  @param x (double) -- location to evaluate spline at
 	 */
 	double operator()(double x);
+
+	/** Evaluate the spline at x; thread-safe.
+	 *
+	 *  The interval is found by bisection.
+	 *
+	 *  @param x (double) -- location to evaluate spline at
+	 */
+	double eval(double x) const;
+
+	/** Evaluate the spline at x, with a caller-owned accelerator; thread-safe.
+	 *
+	 *  Each thread keeps its own accelerator, e.g. a local
+	 *      gsl_interp_accel acc = {0, 0, 0};
+	 *  which pays off when successive points are close together.
+	 *
+	 *  @param x (double) -- location to evaluate spline at
+	 *  @param a (gsl_interp_accel*) -- accelerator
+	 */
+	double eval(double x, gsl_interp_accel *a) const;
+
+	/** Evaluate the spline at a batch of points; thread-safe.
+	 *
+	 *  Equivalent to y[i] = (*this)(x[i]). If x is sorted in increasing
+	 *  order, the knots are walked forward rather than searched, which is
+	 *  much faster for large batches.
+	 *
+	 *  @param x (const double*) -- locations to evaluate spline at
+	 *  @param y (double*) -- returns the values
+	 *  @param n (size_t) -- number of points
+	 */
+	void eval(const double *x, double *y, size_t n) const;
+
+	/** Integrate the spline from a to b; thread-safe.
+	 *
+	 *  The integral of each cubic piece is done analytically. a and b must
+	 *  lie within the knots; if b < a, the integral is negative.
+	 *
+	 *  @param a (double) -- lower limit
+	 *  @param b (double) -- upper limit
+	 */
+	double integral(double a, double b) const;
 };
 
 
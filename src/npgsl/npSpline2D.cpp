@@ -0,0 +1,103 @@
+/*
+ * npSpline2D.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: npadmana
+ */
+
+#include <gsl/gsl_interp.h>
+#include "npSpline2D.h"
+
+using namespace std;
+
+namespace {
+
+// Derivatives at the knots of the natural cubic spline through
+// (x[k], f[k*stride]), written to d[k*stride]
+void knotDerivs(const vector<double>& x, const double *f, double *d, int stride) {
+	int n = x.size();
+	vector<double> ff(n);
+	for (int k=0; k < n; ++k) ff[k] = f[k*stride];
+	gsl_interp *sp = gsl_interp_alloc(gsl_interp_cspline, n);
+	gsl_interp_init(sp, &x[0], &ff[0], n);
+	gsl_interp_accel acc = {0, 0, 0};
+	for (int k=0; k < n; ++k) d[k*stride] = gsl_interp_eval_deriv(sp, &x[0], &ff[0], x[k], &acc);
+	gsl_interp_free(sp);
+}
+
+// Cubic Hermite basis : the coefficients of 1, t, t^2, t^3 from (f0, f1, d0, d1)
+const double hermite[4][4] = {
+		{1, 0, 0, 0},
+		{0, 0, 1, 0},
+		{-3, 3, -2, -1},
+		{2, -2, 1, 1}
+};
+
+}
+
+Spline2D::Spline2D(vector<double> x, vector<double> y, vector<double> z, Type type) {
+	shared_ptr<Table> t = make_shared<Table>();
+	t->type = type;
+	t->x = std::move(x);
+	t->y = std::move(y);
+	t->xaxis = HistAxis(t->x);
+	t->yaxis = HistAxis(t->y);
+	int nx = t->x.size(), ny = t->y.size();
+	t->ntx = (nx-1 + tilesize-1)/tilesize;
+	t->nty = (ny-1 + tilesize-1)/tilesize;
+	t->ncoeff = (type == Bilinear) ? 4 : 16;
+	t->coeff.assign(static_cast<size_t>(t->ncoeff)*t->ntx*t->nty*tilesize*tilesize, 0.0);
+
+	// Derivatives at the knots, along the grid lines; the cross derivative
+	// is the y derivative of the x derivative
+	vector<double> fx, fy, fxy;
+	if (type == Bicubic) {
+		fx.resize(nx*ny); fy.resize(nx*ny); fxy.resize(nx*ny);
+		for (int jj=0; jj < ny; ++jj) knotDerivs(t->x, &z[jj], &fx[jj], ny);
+		for (int ii=0; ii < nx; ++ii) {
+			knotDerivs(t->y, &z[ii*ny], &fy[ii*ny], 1);
+			knotDerivs(t->y, &fx[ii*ny], &fxy[ii*ny], 1);
+		}
+	}
+
+	for (int ii=0; ii < nx-1; ++ii)
+		for (int jj=0; jj < ny-1; ++jj) {
+			double *c = &t->coeff[t->offset(ii, jj)];
+			int k00 = ii*ny+jj, k01 = k00+1, k10 = k00+ny, k11 = k10+1;
+			if (type == Bilinear) {
+				c[0] = z[k00];
+				c[1] = z[k10] - z[k00];
+				c[2] = z[k01] - z[k00];
+				c[3] = z[k11] - z[k10] - z[k01] + z[k00];
+				continue;
+			}
+
+			// Values and scaled derivatives at the corners, as (f0, f1, d0, d1)
+			// in x by (f0, f1, d0, d1) in y; then c = H F H^T
+			double hx = t->x[ii+1] - t->x[ii], hy = t->y[jj+1] - t->y[jj];
+			double F[4][4] = {
+					{z[k00], z[k01], hy*fy[k00], hy*fy[k01]},
+					{z[k10], z[k11], hy*fy[k10], hy*fy[k11]},
+					{hx*fx[k00], hx*fx[k01], hx*hy*fxy[k00], hx*hy*fxy[k01]},
+					{hx*fx[k10], hx*fx[k11], hx*hy*fxy[k10], hx*hy*fxy[k11]}
+			};
+			double HF[4][4];
+			for (int p=0; p < 4; ++p)
+				for (int q=0; q < 4; ++q) {
+					HF[p][q] = 0.0;
+					for (int k=0; k < 4; ++k) HF[p][q] += hermite[p][k]*F[k][q];
+				}
+			for (int p=0; p < 4; ++p)
+				for (int q=0; q < 4; ++q) {
+					double s = 0.0;
+					for (int k=0; k < 4; ++k) s += HF[p][k]*hermite[q][k];
+					c[4*p+q] = s;
+				}
+		}
+
+	table = t;
+}
+
+void Spline2D::eval(const double *x, const double *y, double *z, size_t n) const {
+	for (size_t ii=0; ii < n; ++ii) z[ii] = (*this)(x[ii], y[ii]);
+}
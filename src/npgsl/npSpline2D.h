@@ -0,0 +1,114 @@
+/*
+ * npSpline2D.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: npadmana
+ */
+
+#ifndef NPSPLINE2D_H_
+#define NPSPLINE2D_H_
+
+#include <vector>
+#include <cstddef>
+#include <memory>
+#include "npHistAxis.h"
+
+/** \brief Interpolation of a function tabulated on a 2D grid.
+ *
+ *  The grid is the outer product of increasing knots x and y, which need
+ *  not be equally spaced. In each cell, the interpolant is
+ *     Bilinear : linear in each of x and y
+ *     Bicubic  : the tensor product of natural cubic splines, i.e. the
+ *                bicubic matching the values and the x, y and cross
+ *                derivatives of the 1D splines (gsl_interp_cspline) through
+ *                the grid lines, so it reduces to Spline along a grid line.
+ *
+ *  The coefficients of each cell are precomputed, and stored contiguously.
+ *  The cells are ordered in square tiles, so that cells close in either
+ *  x or y are close in memory. The cell is found in constant time, as for
+ *  HistAxis. Outside the grid, the edge cells are extrapolated.
+ *
+ *  As for Spline, the table is immutable and shared between copies, and
+ *  evaluation is const and thread-safe.
+ */
+class Spline2D {
+public :
+	/// Interpolation type
+	enum Type {Bilinear, Bicubic};
+
+	Spline2D() {};
+
+	/** Constructor.
+	 *
+	 *  The vectors are moved into the spline when they are rvalues, and
+	 *  copied otherwise.
+	 *
+	 *  @param x (vector<double>) -- the x knots, nx of them
+	 *  @param y (vector<double>) -- the y knots, ny of them
+	 *  @param z (vector<double>) -- the values, z[i*ny + j] at (x[i], y[j])
+	 *  @param type (Type) -- Bilinear or Bicubic [Default]; Bicubic needs at least 3 knots in x and y
+	 */
+	Spline2D(std::vector<double> x, std::vector<double> y, std::vector<double> z, Type type=Bicubic);
+
+	/// Interpolation type
+	Type type() const {return table->type;}
+
+	/** Evaluate the spline at (x, y).
+	 *
+	 *  @param x (double) -- x location
+	 *  @param y (double) -- y location
+	 */
+	double operator()(double x, double y) const {
+		const Table& t = *table;
+		int i = t.xaxis.nbins(), j = t.yaxis.nbins();
+		i = cell(t.xaxis, x, i);
+		j = cell(t.yaxis, y, j);
+		double tx = (x - t.x[i])/(t.x[i+1] - t.x[i]);
+		double ty = (y - t.y[j])/(t.y[j+1] - t.y[j]);
+		const double *c = &t.coeff[t.offset(i, j)];
+		if (t.type == Bilinear) return c[0] + tx*(c[1] + ty*c[3]) + ty*c[2];
+		double r[4];
+		for (int p=0; p < 4; ++p) r[p] = c[4*p] + ty*(c[4*p+1] + ty*(c[4*p+2] + ty*c[4*p+3]));
+		return r[0] + tx*(r[1] + tx*(r[2] + tx*r[3]));
+	}
+
+	/** Evaluate the spline at a batch of points
+	 *
+	 *  @param x (const double*) -- x locations
+	 *  @param y (const double*) -- y locations
+	 *  @param z (double*) -- returns the values
+	 *  @param n (size_t) -- number of points
+	 */
+	void eval(const double *x, const double *y, double *z, size_t n) const;
+
+private :
+	// Knots and coefficients, shared between copies
+	struct Table {
+		Type type;
+		std::vector<double> x, y;
+		HistAxis xaxis, yaxis;      // To find the cell
+		int ntx, nty;               // Number of tiles
+		int ncoeff;                 // Coefficients per cell, 4 or 16
+		std::vector<double> coeff;
+
+		// Start of the coefficients of cell (i, j)
+		size_t offset(int i, int j) const {
+			size_t tile = static_cast<size_t>(i/tilesize)*nty + j/tilesize;
+			return ncoeff*((tile*tilesize + i%tilesize)*tilesize + j%tilesize);
+		}
+	};
+	std::shared_ptr<const Table> table;
+
+	// Tiles are tilesize x tilesize cells
+	static const int tilesize = 4;
+
+	// Cell containing x, clamped to the n cells of the axis
+	static int cell(const HistAxis& axis, double x, int n) {
+		int i;
+		if (axis.find(x, i)) return i;
+		return (x < axis.edges()[0]) ? 0 : n-1;
+	}
+};
+
+
+#endif /* NPSPLINE2D_H_ */
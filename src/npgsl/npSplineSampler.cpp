@@ -0,0 +1,84 @@
+/*
+ * npSplineSampler.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: npadmana
+ */
+
+#include <cmath>
+#include "npSplineSampler.h"
+
+using namespace std;
+
+SplineSampler::SplineSampler(const Spline& pdf, int nlut) : pdf_(pdf) {
+	const vector<double>& x = pdf_.table->_x;
+	int n = x.size();
+
+	// Integrals up to each knot
+	cum_.resize(n);
+	cum_[0] = 0.0;
+	for (int ii=0; ii < n-1; ++ii) cum_[ii+1] = cum_[ii] + partial(ii, x[ii+1]);
+
+	// Lookup table, four cells per interval by default
+	nlut_ = (nlut > 0) ? nlut : 4*(n-1);
+	lut_.resize(nlut_);
+	int i = 0;
+	for (int ic=0; ic < nlut_; ++ic) {
+		double t = norm()*ic/nlut_;
+		while ((i < n-2) && (cum_[i+1] <= t)) ++i;
+		lut_[ic] = i;
+	}
+}
+
+double SplineSampler::partial(int i, double x) const {
+	const vector<double>& xa = pdf_.table->_x;
+	gsl_interp_accel a = {static_cast<size_t>(i), 0, 0};
+	return gsl_interp_eval_integ(pdf_.table->sp, &xa[0], &pdf_.table->_y[0], xa[i], x, &a);
+}
+
+double SplineSampler::cumulative(double x) const {
+	const vector<double>& xa = pdf_.table->_x;
+	int n = xa.size();
+	if (!(x > xa[0])) return 0.0;
+	if (x >= xa[n-1]) return norm();
+	int i = gsl_interp_bsearch(&xa[0], x, 0, n-1);
+	return cum_[i] + partial(i, x);
+}
+
+double SplineSampler::quantile(double u) const {
+	const vector<double>& xa = pdf_.table->_x;
+	int n = xa.size();
+	double t = u*norm();
+	if (!(t > 0.0)) return xa[0];
+	if (t >= norm()) return xa[n-1];
+
+	// Interval containing t
+	int ic = static_cast<int>(u*nlut_);
+	int i = lut_[(ic < nlut_) ? ic : nlut_-1];
+	while ((i < n-2) && (cum_[i+1] <= t)) ++i;
+
+	// Solve partial(i, x) = t - cum_[i], starting from a linear guess.
+	// Newton steps that leave the bracket are replaced by bisection.
+	double target = t - cum_[i];
+	double lo = xa[i], hi = xa[i+1];
+	double tol = 1.e-13*(hi-lo);
+	double x = lo + (hi-lo)*(target/(cum_[i+1]-cum_[i]));
+	gsl_interp_accel a = {static_cast<size_t>(i), 0, 0};
+	for (int iter=0; iter < 100; ++iter) {
+		double f = partial(i, x) - target;
+		if (f == 0.0) break;
+		if (f > 0.0) hi = x; else lo = x;
+		a.cache = i;
+		double p = pdf_.eval(x, &a);
+		double x1 = x - f/p;
+		if (!((x1 > lo) && (x1 < hi))) x1 = 0.5*(lo + hi);
+		bool done = (fabs(x1-x) <= tol);
+		x = x1;
+		if (done) break;
+	}
+	return x;
+}
+
+void SplineSampler::quantile(const double *u, double *x, size_t n) const {
+	for (size_t ii=0; ii < n; ++ii) x[ii] = quantile(u[ii]);
+}
@@ -0,0 +1,84 @@
+/*
+ * npSplineSampler.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: npadmana
+ */
+
+#ifndef NPSPLINESAMPLER_H_
+#define NPSPLINESAMPLER_H_
+
+#include <vector>
+#include <cstddef>
+#include "npSpline.h"
+
+/** \brief Cumulative integrals and inverse-transform sampling of a Spline.
+ *
+ *  The spline is treated as an (unnormalized) density p(x) over its knots,
+ *  and must be non-negative there. The integrals up to each knot are
+ *  computed once, analytically, so the cumulative distribution is a table
+ *  lookup plus the integral over a single interval. The inverse uses a
+ *  lookup table from u to the knot interval, followed by a few safeguarded
+ *  Newton steps within the interval, so drawing a sample is O(1), e.g.
+ *      SplineSampler nz(Spline(z, n));
+ *      double z1 = nz.quantile(rnd());
+ *
+ *  The sampler holds a copy of the spline, which shares its table. All
+ *  member functions are const and thread-safe.
+ */
+class SplineSampler {
+public :
+	SplineSampler() : nlut_(0) {};
+
+	/** Constructor.
+	 *
+	 *  @param pdf (Spline) -- the density
+	 *  @param nlut (int) -- number of cells in the inverse lookup table [defaults to 4 per interval]
+	 */
+	SplineSampler(const Spline& pdf, int nlut=0);
+
+	/// Integral of the density over all the knots
+	double norm() const {return cum_.back();}
+
+	/** Integral of the density from the first knot to x.
+	 *
+	 *  This is 0 below the first knot, and norm() above the last.
+	 *
+	 *  @param x (double) -- upper limit
+	 */
+	double cumulative(double x) const;
+
+	/** Cumulative distribution function, cumulative(x)/norm()
+	 *
+	 *  @param x (double) -- upper limit
+	 */
+	double cdf(double x) const {return cumulative(x)/norm();}
+
+	/** Inverse of the cumulative distribution function
+	 *
+	 *  Given a uniform deviate u in [0,1], this is a sample from the density.
+	 *
+	 *  @param u (double) -- probability, in [0,1]
+	 */
+	double quantile(double u) const;
+
+	/** Inverse of the cumulative distribution function for a batch
+	 *
+	 *  @param u (const double*) -- probabilities, in [0,1]
+	 *  @param x (double*) -- returns the quantiles
+	 *  @param n (size_t) -- number of points
+	 */
+	void quantile(const double *u, double *x, size_t n) const;
+
+private :
+	Spline pdf_;
+	std::vector<double> cum_;  // Integral up to each knot
+	int nlut_;
+	std::vector<int> lut_;     // Interval containing the start of each cell in u
+
+	// Integral from knot i to x, in interval i
+	double partial(int i, double x) const;
+};
+
+
+#endif /* NPSPLINESAMPLER_H_ */
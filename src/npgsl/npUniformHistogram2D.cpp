@@ -0,0 +1,87 @@
+/*
+ * npUniformHistogram2D.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: npadmana
+ */
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include "npUniformHistogram2D.h"
+
+namespace {
+
+// Generous bound on the roundoff in (x-xmin)*n/(xmax-xmin) and in the GSL
+// edges, in units of the bin width
+double roundoff(double xmin, double xmax, int n) {
+	double scale = n/(xmax-xmin);
+	return 16*DBL_EPSILON*(std::max(fabs(xmin), fabs(xmax))*scale + n);
+}
+
+}
+
+template <class Accum>
+BasicUniformHistogram2D<Accum>::BasicUniformHistogram2D(int nx, double xmin, double xmax, int ny, double ymin,
+		double ymax) : nx_(nx), ny_(ny), xlo_(xmin), xhi_(xmax), ylo_(ymin), yhi_(ymax) {
+	// Take the edges from GSL, so the binning matches Histogram2D exactly
+	Histogram2D h1(nx, xmin, xmax, ny, ymin, ymax);
+	xr_.assign(h1.hist->xrange, h1.hist->xrange + nx+1);
+	yr_.assign(h1.hist->yrange, h1.hist->yrange + ny+1);
+	xscale_ = nx/(xmax-xmin);
+	yscale_ = ny/(ymax-ymin);
+	xtol_ = roundoff(xmin, xmax, nx);
+	ytol_ = roundoff(ymin, ymax, ny);
+	bins_.assign(nx*ny, value_type());
+}
+
+template <class Accum>
+std::tuple<int, int> BasicUniformHistogram2D<Accum>::nbins() const {
+	return std::make_tuple(nx_, ny_);
+}
+
+template <class Accum>
+void BasicUniformHistogram2D<Accum>::reset() {
+	std::fill(bins_.begin(), bins_.end(), value_type());
+}
+
+template <class Accum>
+std::tuple<double, double> BasicUniformHistogram2D<Accum>::xrange(int i) const {
+	return std::make_tuple(xr_[i], xr_[i+1]);
+}
+
+template <class Accum>
+std::tuple<double, double> BasicUniformHistogram2D<Accum>::yrange(int j) const {
+	return std::make_tuple(yr_[j], yr_[j+1]);
+}
+
+template <class Accum>
+void BasicUniformHistogram2D<Accum>::add(const std::vector<double> &x, const std::vector<double> &y, double w) {
+	for (size_t ii=0; ii<x.size(); ++ii)
+		add(x[ii], y[ii], w);
+}
+
+template <class Accum>
+void BasicUniformHistogram2D<Accum>::add(const std::vector<double> &x, const std::vector<double> &y,
+		const std::vector<double> &w) {
+	for (size_t ii=0; ii<x.size(); ++ii)
+		add(x[ii], y[ii], w[ii]);
+}
+
+template <class Accum>
+void BasicUniformHistogram2D<Accum>::merge(const BasicUniformHistogram2D& h1) {
+	for (size_t ii=0; ii < bins_.size(); ++ii)
+		Accum::merge(bins_[ii], h1.bins_[ii]);
+}
+
+template <class Accum>
+Histogram2D BasicUniformHistogram2D<Accum>::histogram() const {
+	Histogram2D h1(nx_, xlo_, xhi_, ny_, ylo_, yhi_);
+	for (size_t ii=0; ii < bins_.size(); ++ii)
+		h1.hist->bin[ii] = Accum::value(bins_[ii]);
+	return h1;
+}
+
+template class BasicUniformHistogram2D<DoubleAccumulator>;
+template class BasicUniformHistogram2D<KahanAccumulator>;
+template class BasicUniformHistogram2D<CountAccumulator>;
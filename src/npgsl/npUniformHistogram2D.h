@@ -0,0 +1,185 @@
+/*
+ * npUniformHistogram2D.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: npadmana
+ */
+
+#ifndef NPUNIFORMHISTOGRAM2D_H_
+#define NPUNIFORMHISTOGRAM2D_H_
+
+#include <tuple>
+#include <vector>
+#include "npHistogram2D.h"
+#include "npHistAccumulator.h"
+
+/** A 2D histogram with uniform bins
+ *
+ * This bins exactly as a uniform Histogram2D does (lower bin edges inclusive,
+ * upper exclusive, with the same edges as GSL), but finds the bin with a
+ * multiply and truncate, rather than a search. The bins are stored
+ * contiguously in row-major order, (i, j) at i*ny + j.
+ *
+ * add is inline, since this is meant for inner loops.
+ *
+ * The bins are accumulated according to Accum (see npHistAccumulator.h) :
+ *     UniformHistogram2D       : doubles
+ *     KahanUniformHistogram2D  : compensated doubles, for large totals
+ *     CountUniformHistogram2D  : uint64 counts, for unweighted data
+ */
+template <class Accum>
+class BasicUniformHistogram2D {
+public :
+	/// Type of a bin
+	typedef typename Accum::value_type value_type;
+
+	/** Basic constructor class
+	 *
+	 */
+	BasicUniformHistogram2D() : nx_(0), ny_(0) {};
+
+	/** Basic constructor for uniform bins
+	 *
+	 * @param nx : Number of xbins
+	 * @param xmin : minimum value in x
+	 * @param xmax : maximum value in x
+	 * @param ny : Number of ybins
+	 * @param ymin : minimum value in y
+	 * @param ymax : maximum value in y
+	 *
+	 */
+	BasicUniformHistogram2D(int nx, double xmin, double xmax, int ny, double ymin, double ymax);
+
+	/** Get the number of bins
+	 *
+	 * returns a std::tuple<int, int> with (nx, ny)
+	 */
+	std::tuple<int, int> nbins() const;
+
+	/** Reset the bins
+	 *
+	 */
+	void reset();
+
+	/** Get range of the i'th bin in the x direction
+	 *
+	 *  Note the lower limit is inclusive, and the upper limit is exclusive.
+	 *
+	 *  @param i (int) : i'th bin
+	 *
+	 *  returns std::tuple<double, double>
+	 */
+	std::tuple<double, double> xrange(int i) const;
+
+	/** Get range of the j'th bin in the y direction
+	 *
+	 * Note the lower limit is inclusive, while the upper limit is exclusive
+	 *
+	 * @param j (int) : j'th bin
+	 *
+	 * returns std::tuple<double, double>
+	 */
+	std::tuple<double, double> yrange(int j) const;
+
+	/** Get the value in the i,j bin
+	 *
+	 * @param i (int) : i bin
+	 * @param j (int) : j bin
+	 *
+	 * returns (double) bin contents
+	 */
+	double operator()(int i, int j) const {return Accum::value(bins_[i*ny_ + j]);}
+
+	/** Increment x,y with weight.
+	 *
+	 * If x,y not in histogram range, this is silently dropped.
+	 *
+	 * @param x (double) : xval
+	 * @param y (double) : yval
+	 * @param w (double) : weight
+	 */
+	void add(double x, double y, double weight) {
+		int i, j;
+		if (findBin(x, xlo_, xscale_, xtol_, xr_, nx_, i) & findBin(y, ylo_, yscale_, ytol_, yr_, ny_, j))
+			Accum::add(bins_[i*ny_ + j], weight);
+	}
+
+	/** Increment x,y with unit weight.
+	 *
+	 * If x,y not in histogram range, this is silently dropped.
+	 *
+	 * @param x (double) : xval
+	 * @param y (double) : yval
+	 */
+	void add(double x, double y) {
+		int i, j;
+		if (findBin(x, xlo_, xscale_, xtol_, xr_, nx_, i) & findBin(y, ylo_, yscale_, ytol_, yr_, ny_, j))
+			Accum::increment(bins_[i*ny_ + j]);
+	}
+
+	/** Increment x,y with weight.
+	 *
+	 * This version assumes the same weight for everything.
+	 *
+	 * @param x (vector<double>) : xval
+	 * @param y (vector<double>) : yval
+	 * @param w (double) : weight [defaults to 1.0]
+	 */
+	void add(const std::vector<double> &x, const std::vector<double> &y, double w=1.0);
+
+	/** Increment x,y with weight.
+	 *
+	 * @param x (vector<double>) : xval
+	 * @param y (vector<double>) : yval
+	 * @param w (vector<double>) : weight
+	 */
+	void add(const std::vector<double> &x, const std::vector<double> &y, const std::vector<double> &w);
+
+	/** Add the contents of another histogram into this one
+	 *
+	 * The two histograms must have identical binning.
+	 *
+	 * @param h1 (const BasicUniformHistogram2D&) : histogram to add in
+	 */
+	void merge(const BasicUniformHistogram2D &h1);
+
+	/// Pointer to the bins, in row-major order
+	const value_type* data() const {return bins_.data();}
+
+	/** Copy into a Histogram2D
+	 *
+	 * returns Histogram2D
+	 */
+	Histogram2D histogram() const;
+
+private :
+	int nx_, ny_;
+	double xlo_, xhi_, xscale_, xtol_, ylo_, yhi_, yscale_, ytol_;
+	std::vector<double> xr_, yr_;  // Bin edges, as GSL computes them
+	std::vector<value_type> bins_;
+
+	/* Bin containing x, for n bins with edges r; false if x is out of range.
+	 * The multiply and truncate can be off by one when x is within roundoff
+	 * (tol, in units of the bin width) of an edge; only then is the bin
+	 * checked against the edges.
+	 */
+	static bool findBin(double x, double lo, double scale, double tol, const std::vector<double>& r, int n, int& i) {
+		double u = (x-lo)*scale;
+		if (!((x >= r[0]) & (x < r[n]))) return false;
+		i = static_cast<int>(u);
+		if (i > n-1) i = n-1;
+		double f = u - i;
+		if ((f < tol) | (f > 1-tol)) {
+			i -= (x < r[i]);
+			i += (x >= r[i+1]);
+		}
+		return true;
+	}
+};
+
+typedef BasicUniformHistogram2D<DoubleAccumulator> UniformHistogram2D;
+typedef BasicUniformHistogram2D<KahanAccumulator> KahanUniformHistogram2D;
+typedef BasicUniformHistogram2D<CountAccumulator> CountUniformHistogram2D;
+
+
+#endif /* NPUNIFORMHISTOGRAM2D_H_ */
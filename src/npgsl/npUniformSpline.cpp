@@ -0,0 +1,48 @@
+/*
+ * npUniformSpline.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: npadmana
+ */
+
+#include <cmath>
+#include "npUniformSpline.h"
+
+using namespace std;
+
+UniformSpline::UniformSpline(double xmin, double xmax, const vector<double>& y, const gsl_interp_type *sptype) :
+		n_(y.size()), x0_(xmin) {
+	if ((n_ < 2) || (n_ < static_cast<int>(gsl_interp_type_min_size(sptype))))
+		throw invalid_argument("UniformSpline has too few knots for this spline type");
+	h_ = (xmax - xmin)/(n_-1);
+	invh_ = (n_-1)/(xmax - xmin);
+
+	// Fit with GSL on the same knots
+	vector<double> x(n_);
+	for (int ii=0; ii < n_; ++ii) x[ii] = xmin + ii*h_;
+	x[n_-1] = xmax;
+	gsl_interp *sp = gsl_interp_alloc(sptype, n_);
+	gsl_interp_init(sp, &x[0], &y[0], n_);
+	gsl_interp_accel acc = {0, 0, 0};
+
+	// Each interval is the cubic Hermite interpolant, matching the values
+	// and slopes at the two ends. The slope at the top is taken just inside
+	// the interval, so this is exact for the piecewise cubic splines, even
+	// where the slope is discontinuous.
+	coeff_.resize(4*(n_-1));
+	for (int ii=0; ii < n_-1; ++ii) {
+		double y0 = y[ii], y1 = y[ii+1];
+		double d0 = h_*gsl_interp_eval_deriv(sp, &x[0], &y[0], x[ii], &acc);
+		double d1 = h_*gsl_interp_eval_deriv(sp, &x[0], &y[0], nextafter(x[ii+1], x[ii]), &acc);
+		double *c = &coeff_[4*ii];
+		c[0] = y0;
+		c[1] = d0;
+		c[2] = 3*(y1-y0) - 2*d0 - d1;
+		c[3] = 2*(y0-y1) + d0 + d1;
+	}
+	gsl_interp_free(sp);
+}
+
+void UniformSpline::eval(const double *x, double *y, size_t n) const {
+	for (size_t ii=0; ii < n; ++ii) y[ii] = (*this)(x[ii]);
+}
@@ -0,0 +1,90 @@
+/*
+ * npUniformSpline.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: npadmana
+ */
+
+#ifndef NPUNIFORMSPLINE_H_
+#define NPUNIFORMSPLINE_H_
+
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+#include <gsl/gsl_interp.h>
+
+/** \brief A spline on equally spaced knots, with constant time lookup.
+ *
+ *  The spline is fit by GSL, as for Spline, and then stored as a cubic
+ *  per interval,
+ *      y = c0 + t*(c1 + t*(c2 + t*c3)),  t = (x - x_i)/h,
+ *  with the four coefficients of each interval adjacent in one array. The
+ *  interval is found by a multiply and truncate, so evaluation is a handful
+ *  of flops and one cache line. Evaluation is const and thread-safe.
+ *
+ *  Outside [xmin, xmax], the end intervals are extrapolated.
+ */
+class UniformSpline {
+public :
+	/// An empty spline, to be assigned to; evaluating it throws std::invalid_argument
+	UniformSpline() : n_(0), x0_(0.0), h_(1.0), invh_(1.0) {};
+
+	/** Constructor.
+	 *
+	 *  @param xmin (double) -- the first knot
+	 *  @param xmax (double) -- the last knot
+	 *  @param y (vector<double>) -- the values at the knots, equally spaced from xmin to xmax;
+	 *        at least 2 of them, and as many as sptype needs, else this
+	 *        throws std::invalid_argument
+	 *  @param sptype -- gsl spline type (defaults to gsl_interp_cspline)
+	 *        The options here are as for Spline :
+	 *           gsl_interp_linear
+	 *           gsl_interp_polynomial
+	 *           gsl_interp_cspline [Default]
+	 *           gsl_interp_cspline_periodic
+	 *           gsl_interp_akima
+	 *           gsl_interp_akima_periodic
+	 *        These are all piecewise cubics, and are reproduced to roundoff,
+	 *        except gsl_interp_polynomial, which is replaced in each interval
+	 *        by the cubic matching its values and slopes at the two ends.
+	 */
+	UniformSpline(double xmin, double xmax, const std::vector<double>& y,
+			const gsl_interp_type *sptype = gsl_interp_cspline);
+
+	/// Number of knots
+	int size() const {return n_;}
+
+	/** Evaluate the spline at x.
+	 *
+	 *  @param x (double) -- location to evaluate spline at
+	 */
+	double operator()(double x) const {
+		if (n_ < 2) throw std::invalid_argument("UniformSpline needs at least 2 knots");
+		double u = (x - x0_)*invh_;
+		double top = n_-2;
+		double v = (u > 0.0) ? u : 0.0;
+		int i = static_cast<int>((v < top) ? v : top);
+		double t = u - i;
+		const double *c = &coeff_[4*i];
+		return c[0] + t*(c[1] + t*(c[2] + t*c[3]));
+	}
+
+	/** Evaluate the spline at a batch of points
+	 *
+	 *  @param x (const double*) -- locations to evaluate spline at
+	 *  @param y (double*) -- returns the values
+	 *  @param n (size_t) -- number of points
+	 */
+	void eval(const double *x, double *y, size_t n) const;
+
+	/// Coefficients, four per interval
+	const double* data() const {return coeff_.data();}
+
+private :
+	int n_;
+	double x0_, h_, invh_;
+	std::vector<double> coeff_;
+};
+
+
+#endif /* NPUNIFORMSPLINE_H_ */
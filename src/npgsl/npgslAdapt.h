@@ -8,6 +8,8 @@
 #ifndef NPGSLADAPT_H_
 #define NPGSLADAPT_H_
 
+#include "gsl/gsl_math.h"
+
 template<class F>
 static double gslFunctionAdapter( double x, void* p)
 {
@@ -17,8 +19,13 @@ static double gslFunctionAdapter( double x, void* p)
     return (*function)( x );
 }
 
-/** Helper function to wrap normal C++
-
+/** Helper function to wrap normal C++ function objects (including lambdas)
+ * as a gsl_function.
+ *
+ * The function object is not copied, so it must outlive the gsl_function.
+ *
+ * @param f (const F&) : function object, callable as f(double)
+ */
 template<class F>
 gsl_function convertToGslFunction( const F& f )
 {
@@ -0,0 +1,76 @@
+#include <thread>
+#include "gtest/gtest.h"
+#include "npConcurrentHistogram2D.h"
+
+
+TEST(ConcurrentHist2D, NxNy) {
+	ConcurrentHistogram2D h1(5, 0.0, 1.0, 2, 0.0, 1.0, 3);
+	std::tuple<int,int> tmp = h1.nbins();
+	EXPECT_EQ(5, std::get<0>(tmp));
+	EXPECT_EQ(2, std::get<1>(tmp));
+	EXPECT_EQ(3, h1.nshards());
+}
+
+TEST(ConcurrentHist2D, Fill1) {
+	ConcurrentHistogram2D h1(5, 0.0, 1.0, 2, 0.0, 1.0);
+	h1.add(1.1, -1.1, 10.0);
+	h1.add(0.5, 1.0, 10.0);
+	h1.add(-0.1, 0.3, 1.0);
+	for (int ii=0; ii < 5; ++ii)
+		for (int jj=0; jj<2; ++jj)
+			EXPECT_DOUBLE_EQ(0.0, h1(ii,jj));
+}
+
+TEST(ConcurrentHist2D, MatchesHistogram2D) {
+	Histogram2D h0(7, 0.0, 1.0, 3, -1.0, 1.0);
+	ConcurrentHistogram2D h1(h0, 2);
+	for (int ii=0; ii <= 70; ++ii) {
+		double x = ii/70.0, y = -1.0 + ii/35.0;
+		h0.add(x, y, ii);
+		h1.add(x, y, ii);
+	}
+	Histogram2D h2 = h1.histogram();
+	for (int ii=0; ii < 7; ++ii)
+		for (int jj=0; jj<3; ++jj) {
+			EXPECT_DOUBLE_EQ(h0(ii,jj), h1(ii,jj));
+			EXPECT_DOUBLE_EQ(h0(ii,jj), h2(ii,jj));
+		}
+}
+
+// Log and Edges binning, from the prototype's axes
+TEST(ConcurrentHist2D, LogEdgeBins) {
+	std::vector<double> yedges = {-1.0, 0.0, 0.1, 1.0};
+	Histogram2D h0(HistAxis(20000, 1.9, 1.95, HistAxis::Log), HistAxis(yedges));
+	ConcurrentHistogram2D h1(h0, 2);
+	for (int ii=0; ii <= 100; ++ii) {
+		double x = 1.9 + ii*0.0005, y = -1.0 + ii/50.0;
+		h0.add(x, y, ii);
+		h1.add(x, y, ii);
+	}
+	Histogram2D h2 = h1.histogram();
+	EXPECT_EQ(HistAxis::Log, h2.xaxis().scale());
+	EXPECT_EQ(HistAxis::Edges, h2.yaxis().scale());
+	for (int ii=0; ii < 20000; ++ii)
+		for (int jj=0; jj<3; ++jj) EXPECT_EQ(h0(ii,jj), h2(ii,jj));
+}
+
+TEST(ConcurrentHist2D, Threads) {
+	ConcurrentHistogram2D h1(5, 0.0, 1.0, 2, 0.0, 1.0, 2);
+	std::vector<std::thread> threads;
+	for (int it=0; it < 4; ++it)
+		threads.push_back(std::thread([&h1]() {
+			for (int nn=0; nn < 1000; ++nn)
+				for (int ii=0; ii < 5; ++ii)
+					for (int jj=0; jj < 2; ++jj)
+						h1.add(ii*0.2+0.1, jj*0.5+0.25, 0.5);
+		}));
+	for (std::thread &t : threads) t.join();
+	for (int ii=0; ii < 5; ++ii)
+		for (int jj=0; jj<2; ++jj)
+			EXPECT_DOUBLE_EQ(2000.0, h1(ii,jj));
+
+	h1.reset();
+	for (int ii=0; ii < 5; ++ii)
+		for (int jj=0; jj<2; ++jj)
+			EXPECT_DOUBLE_EQ(0.0, h1(ii,jj));
+}
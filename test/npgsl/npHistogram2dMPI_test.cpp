@@ -0,0 +1,41 @@
+#include "gtest/gtest.h"
+#include "npHistogram2DMPI.h"
+
+// Run as mpirun -np <nproc> npHistogram2dMPI_test; this also works on one rank.
+
+TEST(Hist2DMPI, Allreduce) {
+	int rank, size;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+	Histogram2D h1(5, 0.0, 1.0, 2, 0.0, 1.0);
+	for (int ii=0; ii < 5; ++ii)
+		for (int jj=0; jj < 2; ++jj)
+			h1.add(ii*0.2+0.1, jj*0.5+0.25, (rank+1)*(ii+jj));
+	EXPECT_EQ(MPI_SUCCESS, Histogram2DMPI::allreduce(h1));
+	for (int ii=0; ii < 5; ++ii)
+		for (int jj=0; jj<2; ++jj)
+			EXPECT_DOUBLE_EQ(0.5*size*(size+1)*(ii+jj), h1(ii,jj));
+}
+
+TEST(Hist2DMPI, Reduce) {
+	int rank, size;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+	int root = size-1;
+	Histogram2D h1(5, 0.0, 1.0, 2, 0.0, 1.0);
+	for (int ii=0; ii < 5; ++ii)
+		for (int jj=0; jj < 2; ++jj)
+			h1.add(ii*0.2+0.1, jj*0.5+0.25, rank+ii);
+	EXPECT_EQ(MPI_SUCCESS, Histogram2DMPI::reduce(h1, root, MPI_COMM_WORLD));
+	for (int ii=0; ii < 5; ++ii)
+		for (int jj=0; jj<2; ++jj)
+			EXPECT_DOUBLE_EQ((rank == root) ? 0.5*size*(size-1) + size*ii : rank+ii, h1(ii,jj));
+}
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	MPI_Init(&argc, &argv);
+	int retval = RUN_ALL_TESTS();
+	MPI_Finalize();
+	return retval;
+}
@@ -1,3 +1,5 @@
+#include <cmath>
+#include <cstring>
 #include "gtest/gtest.h"
 #include "npHistogram2D.h"
 
@@ -161,3 +163,263 @@ TEST(Hist2D, AssignmentOperator) {
 
 
 
+TEST(Hist2D, Merge) {
+	Histogram2D h1(5, 0.0, 1.0, 2, 0.0, 1.0), h2(5, 0.0, 1.0, 2, 0.0, 1.0);
+	for (int ii=0; ii < 5; ++ii)
+		for (int jj=0; jj < 2; ++jj) {
+			h1.add(ii*0.2+0.1, jj*0.5+0.25, 3.0);
+			if (ii%2==0) h2.add(ii*0.2+0.1, jj*0.5+0.25, 1.0);
+		}
+	h1.merge(h2);
+	for (int ii=0; ii < 5; ++ii)
+		for (int jj=0; jj<2; ++jj)
+			EXPECT_DOUBLE_EQ((ii%2==0) ? 4.0 : 3.0, h1(ii,jj));
+}
+
+
+
+TEST(Hist2D, ReadWrite) {
+	Histogram2D h1(5, 0.0, 1.0, 2, 0.0, 1.0), h2(5, 0.0, 1.0, 2, 0.0, 1.0);
+	for (int ii=0; ii < 5; ++ii)
+		for (int jj=0; jj < 2; ++jj)
+			h1.add(ii*0.2+0.1, jj*0.5+0.25, ii+jj);
+	FILE *fp = tmpfile();
+	EXPECT_EQ(0, h1.fwrite(fp));
+	rewind(fp);
+	EXPECT_EQ(0, h2.fread(fp));
+	fclose(fp);
+	for (int ii=0; ii < 5; ++ii)
+		for (int jj=0; jj<2; ++jj)
+			EXPECT_DOUBLE_EQ(ii+jj, h2(ii,jj));
+}
+
+
+
+
+
+
+// The batch adds must match adding the points one at a time
+TEST(Hist2D, BatchAdd) {
+	Histogram2D h0(7, 0.1, 0.4, 30, -1.0, 1.0000000001), h1(h0), h2(h0);
+	std::vector<double> xx, yy, ww;
+	unsigned int seed = 1;
+	for (int ii=0; ii < 1000; ++ii) {
+		seed = seed*1664525u + 1013904223u;
+		xx.push_back(0.08 + 0.34*(seed/4294967296.0));
+		seed = seed*1664525u + 1013904223u;
+		yy.push_back(-1.01 + 2.02*(seed/4294967296.0));
+		ww.push_back(0.1*(ii%7));
+	}
+	for (int ii=0; ii < 7; ++ii) {
+		xx.push_back(std::get<0>(h0.xrange(ii)));
+		yy.push_back(std::get<0>(h0.yrange(ii)));
+		ww.push_back(1.0);
+	}
+	for (int ii=0; ii < xx.size(); ++ii) h0.add(xx[ii], yy[ii], ww[ii]);
+	h1.add(xx, yy, ww);
+	h2.add(&xx[0], &yy[0], &ww[0], 500);
+	h2.add(&xx[500], &yy[500], &ww[500], xx.size()-500);
+	for (int ii=0; ii < 7; ++ii)
+		for (int jj=0; jj<30; ++jj) {
+			EXPECT_EQ(h0(ii,jj), h1(ii,jj));
+			EXPECT_EQ(h0(ii,jj), h2(ii,jj));
+		}
+}
+
+TEST(Hist2D, BatchAddConstant) {
+	Histogram2D h0(5, 0.0, 1.0, 2, 0.0, 1.0), h1(h0), h2(h0);
+	double xx[4] = {0.1, 0.5, 0.5, 0.9}, yy[4] = {0.2, 0.7, 0.7, 0.3};
+	for (int ii=0; ii < 4; ++ii) h0.add(xx[ii], yy[ii], 2.5);
+	h1.add(xx, yy, 4);
+	h2.addConstant(xx, yy, 4, 2.5);
+	for (int ii=0; ii < 5; ++ii)
+		for (int jj=0; jj<2; ++jj) {
+			EXPECT_DOUBLE_EQ(h0(ii,jj), 2.5*h1(ii,jj));
+			EXPECT_DOUBLE_EQ(h0(ii,jj), h2(ii,jj));
+		}
+}
+
+TEST(Hist2D, BatchAddOutOfRange) {
+	Histogram2D h1(5, 0.0, 1.0, 2, 0.0, 1.0);
+	double xx[4] = {1.1, 0.5, -0.1, NAN}, yy[4] = {-1.1, 1.0, 0.3, 0.3};
+	h1.addConstant(xx, yy, 4, 10.0);
+	h1.add(xx, yy, 4);
+	for (int ii=0; ii < 5; ++ii)
+		for (int jj=0; jj<2; ++jj)
+			EXPECT_DOUBLE_EQ(0.0, h1(ii,jj));
+}
+
+
+
+TEST(Hist2D, LogBins) {
+	Histogram2D h1(HistAxis(4, 1.0, 1.e4, HistAxis::Log), HistAxis(2, 0.0, 1.0));
+	for (int ii=0; ii < 4; ++ii) {
+		EXPECT_NEAR(pow(10.0, ii), std::get<0>(h1.xrange(ii)), 1.e-9*pow(10.0, ii));
+		h1.add(3*pow(10.0, ii), 0.25, ii+1);
+		h1.add(std::get<0>(h1.xrange(ii)), 0.75, ii+1);
+	}
+	h1.add(0.5, 0.25);
+	h1.add(1.e4, 0.25);
+	for (int ii=0; ii < 4; ++ii)
+		for (int jj=0; jj<2; ++jj)
+			EXPECT_DOUBLE_EQ(ii+1, h1(ii,jj));
+}
+
+// Fine log bins, where fastLog is off by several bins at the ends
+TEST(Hist2D, FineLogBins) {
+	Histogram2D h1(HistAxis(20000, 1.9, 1.95, HistAxis::Log), HistAxis(1, 0.0, 1.0)), h2(h1);
+	double xx[3] = {1.9, nextafter(1.95, 0.0), 1.925}, yy[3] = {0.5, 0.5, 0.5};
+	for (int ii=0; ii < 3; ++ii) h1.add(xx[ii], yy[ii], 1.0);
+	h2.add(xx, yy, 3);
+	double sum1 = 0.0, sum2 = 0.0;
+	for (int ii=0; ii < 20000; ++ii) {
+		sum1 += h1(ii,0);
+		sum2 += h2(ii,0);
+	}
+	EXPECT_DOUBLE_EQ(3.0, sum1);
+	EXPECT_DOUBLE_EQ(3.0, sum2);
+	EXPECT_DOUBLE_EQ(1.0, h1(0,0));
+	EXPECT_DOUBLE_EQ(1.0, h1(19999,0));
+	EXPECT_DOUBLE_EQ(1.0, h2(0,0));
+	EXPECT_DOUBLE_EQ(1.0, h2(19999,0));
+}
+
+TEST(Hist2D, EdgeBins) {
+	std::vector<double> xedges = {0.0, 0.1, 0.15, 0.5, 2.0}, yedges = {-1.0, 0.0, 1.0};
+	Histogram2D h1(xedges, yedges), h2(xedges, yedges);
+	std::vector<double> xx, yy;
+	for (int ii=0; ii < 4; ++ii) {
+		EXPECT_DOUBLE_EQ(xedges[ii], std::get<0>(h1.xrange(ii)));
+		EXPECT_DOUBLE_EQ(xedges[ii+1], std::get<1>(h1.xrange(ii)));
+		for (int jj=0; jj < 2; ++jj) {
+			h1.add(xedges[ii], yedges[jj], 2.0);
+			h1.add(0.5*(xedges[ii]+xedges[ii+1]), 0.5*(yedges[jj]+yedges[jj+1]));
+			xx.push_back(xedges[ii]); yy.push_back(yedges[jj]);
+			xx.push_back(nextafter(xedges[ii+1], -10.0)); yy.push_back(yedges[jj]);
+		}
+	}
+	h1.add(2.0, 0.0);
+	h2.add(xx, yy, 1.5);
+	for (int ii=0; ii < 4; ++ii)
+		for (int jj=0; jj<2; ++jj) {
+			EXPECT_DOUBLE_EQ(3.0, h1(ii,jj));
+			EXPECT_DOUBLE_EQ(3.0, h2(ii,jj));
+		}
+}
+
+TEST(Hist2D, ReadWriteEdges) {
+	Histogram2D h1(HistAxis(4, 1.0, 1.e4, HistAxis::Log), HistAxis(2, 0.0, 1.0)), h2(4, 0.0, 1.0, 2, 0.0, 1.0);
+	h1.add(500.0, 0.7, 2.0);
+	FILE *fp = tmpfile();
+	EXPECT_EQ(0, h1.fwrite(fp));
+	rewind(fp);
+	EXPECT_EQ(0, h2.fread(fp));
+	fclose(fp);
+	EXPECT_EQ(HistAxis::Log, h2.xaxis().scale());
+	EXPECT_EQ(HistAxis::Linear, h2.yaxis().scale());
+	EXPECT_DOUBLE_EQ(2.0, h2(2,1));
+	h2.add(50.0, 0.2, 1.0);
+	EXPECT_DOUBLE_EQ(1.0, h2(1,0));
+
+	// Arbitrary edges stay arbitrary
+	std::vector<double> edges = {0.0, 0.1, 0.5, 0.6, 1.0};
+	Histogram2D h3(edges, edges), h4(4, 0.0, 1.0, 4, 0.0, 1.0);
+	fp = tmpfile();
+	EXPECT_EQ(0, h3.fwrite(fp));
+	rewind(fp);
+	EXPECT_EQ(0, h4.fread(fp));
+	fclose(fp);
+	EXPECT_EQ(HistAxis::Edges, h4.xaxis().scale());
+	EXPECT_EQ(HistAxis::Edges, h4.yaxis().scale());
+}
+
+TEST(Hist2D, MoveConstructor) {
+	Histogram2D h1(5, 0.0, 1.0, 2, 0.0, 1.0);
+	h1.add(0.5, 0.75, 3.0);
+	Histogram2D h2(std::move(h1));
+	EXPECT_DOUBLE_EQ(3.0, h2(2,1));
+	std::vector<Histogram2D> hists;
+	hists.push_back(std::move(h2));
+	hists.push_back(Histogram2D(3, 0.0, 1.0, 3, 0.0, 1.0));
+	hists[0].add(0.1, 0.1, 1.0);
+	EXPECT_DOUBLE_EQ(3.0, hists[0](2,1));
+	EXPECT_DOUBLE_EQ(1.0, hists[0](0,0));
+	std::tuple<int,int> tmp = hists[1].nbins();
+	EXPECT_EQ(3, std::get<0>(tmp));
+}
+
+TEST(Hist2D, MoveAssignment) {
+	Histogram2D h1(5, 0.0, 1.0, 2, 0.0, 1.0), h2(HistAxis(4, 1.0, 1.e4, HistAxis::Log), HistAxis(2, 0.0, 1.0));
+	h2.add(500.0, 0.7, 2.0);
+	h1 = std::move(h2);
+	std::tuple<int,int> tmp = h1.nbins();
+	EXPECT_EQ(4, std::get<0>(tmp));
+	EXPECT_DOUBLE_EQ(2.0, h1(2,1));
+	h1.add(50.0, 0.2, 1.0);
+	EXPECT_DOUBLE_EQ(1.0, h1(1,0));
+}
+
+TEST(Hist2D, Serialize) {
+	Histogram2D h1(HistAxis(4, 1.0, 1.e4, HistAxis::Log), HistAxis(2, 0.0, 1.0)), h2;
+	h1.add(500.0, 0.7, 2.0);
+	h1.add(5.0, 0.1, 1.5);
+	std::vector<char> buf = h1.serialize();
+	EXPECT_EQ(h1.serializedSize(), buf.size());
+	EXPECT_EQ(0u, h2.deserialize(buf.data(), buf.size()-1));
+	EXPECT_EQ(buf.size(), h2.deserialize(buf.data(), buf.size()));
+	std::tuple<int,int> tmp = h2.nbins();
+	EXPECT_EQ(4, std::get<0>(tmp));
+	EXPECT_EQ(2, std::get<1>(tmp));
+	for (int ii=0; ii < 4; ++ii) {
+		EXPECT_EQ(std::get<0>(h1.xrange(ii)), std::get<0>(h2.xrange(ii)));
+		EXPECT_EQ(std::get<1>(h1.xrange(ii)), std::get<1>(h2.xrange(ii)));
+		for (int jj=0; jj < 2; ++jj)
+			EXPECT_EQ(h1(ii,jj), h2(ii,jj));
+	}
+	EXPECT_EQ(HistAxis::Log, h2.xaxis().scale());
+	EXPECT_EQ(HistAxis::Linear, h2.yaxis().scale());
+	h2.add(50.0, 0.2, 1.0);
+	EXPECT_DOUBLE_EQ(1.0, h2(1,0));
+
+	std::vector<double> edges = {0.0, 0.1, 0.5, 0.6, 1.0};
+	Histogram2D h3(edges, edges);
+	buf = h3.serialize();
+	EXPECT_EQ(buf.size(), h2.deserialize(buf.data(), buf.size()));
+	EXPECT_EQ(HistAxis::Edges, h2.xaxis().scale());
+}
+
+TEST(Hist2D, SerializeEmpty) {
+	Histogram2D h1, h2(5, 0.0, 1.0, 2, 0.0, 1.0);
+	std::vector<char> buf = h1.serialize();
+	EXPECT_EQ(h1.serializedSize(), buf.size());
+	EXPECT_EQ(buf.size(), h2.deserialize(buf.data(), buf.size()));
+
+	// Moved from
+	Histogram2D h3(5, 0.0, 1.0, 2, 0.0, 1.0), h4(std::move(h3));
+	EXPECT_EQ(buf, h3.serialize());
+	buf = h2.serialize();
+	EXPECT_EQ(buf.size(), h3.deserialize(buf.data(), buf.size()));
+}
+
+TEST(Hist2D, SerializeCorrupt) {
+	Histogram2D h1(5, 0.0, 1.0, 2, 0.0, 1.0), h2;
+	std::vector<char> buf = h1.serialize();
+	int64_t head[2];
+
+	// nx*ny wraps around to a small number
+	head[0] = int64_t(1) << 31; head[1] = int64_t(1) << 33;
+	memcpy(buf.data(), head, sizeof(head));
+	EXPECT_EQ(0u, h2.deserialize(buf.data(), buf.size()));
+	head[0] = 5; head[1] = -2;
+	memcpy(buf.data(), head, sizeof(head));
+	EXPECT_EQ(0u, h2.deserialize(buf.data(), buf.size()));
+	head[0] = 5; head[1] = 3;
+	memcpy(buf.data(), head, sizeof(head));
+	EXPECT_EQ(0u, h2.deserialize(buf.data(), buf.size()));
+
+	// Edges that are not those of the scale
+	buf = h1.serialize();
+	double x = 0.3;
+	memcpy(buf.data() + 4*sizeof(int64_t) + 2*sizeof(double), &x, sizeof(double));
+	EXPECT_EQ(0u, h2.deserialize(buf.data(), buf.size()));
+}
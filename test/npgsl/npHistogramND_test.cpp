@@ -0,0 +1,106 @@
+#include <cmath>
+#include "gtest/gtest.h"
+#include "npHistogramND.h"
+#include "npHistogram2D.h"
+
+
+TEST(HistAxis, Linear) {
+	HistAxis ax(5, 0.0, 1.0);
+	EXPECT_EQ(5, ax.nbins());
+	for (int ii=0; ii < 5; ++ii) {
+		EXPECT_NEAR(ii*0.2, std::get<0>(ax.range(ii)), 1.e-12);
+		EXPECT_NEAR((ii+1)*0.2, std::get<1>(ax.range(ii)), 1.e-12);
+	}
+	int i;
+	EXPECT_FALSE(ax.find(-0.1, i));
+	EXPECT_FALSE(ax.find(1.0, i));
+	EXPECT_FALSE(ax.find(NAN, i));
+	EXPECT_TRUE(ax.find(0.0, i));
+	EXPECT_EQ(0, i);
+	EXPECT_TRUE(ax.find(0.5, i));
+	EXPECT_EQ(2, i);
+}
+
+TEST(HistAxis, Log) {
+	HistAxis ax(4, 1.0, 1.e4, HistAxis::Log);
+	for (int ii=0; ii < 4; ++ii) {
+		EXPECT_NEAR(pow(10.0, ii), std::get<0>(ax.range(ii)), 1.e-9*pow(10.0, ii));
+		EXPECT_NEAR(pow(10.0, ii+1), std::get<1>(ax.range(ii)), 1.e-9*pow(10.0, ii+1));
+	}
+	int i = -1;
+	EXPECT_TRUE(ax.find(5.0, i));
+	EXPECT_EQ(0, i);
+	EXPECT_TRUE(ax.find(500.0, i));
+	EXPECT_EQ(2, i);
+	EXPECT_FALSE(ax.find(0.5, i));
+
+	// Points on an edge go in the bin above
+	for (int ii=0; ii < 4; ++ii) {
+		EXPECT_TRUE(ax.find(std::get<0>(ax.range(ii)), i));
+		EXPECT_EQ(ii, i);
+	}
+}
+
+TEST(HistND, Fill1D) {
+	Histogram1D h1(HistAxis(5, 0.0, 1.0));
+	for (int ii=0; ii < 5; ++ii) h1.add(ii*0.2+0.1, 2.0);
+	h1.add(1.5);
+	for (int ii=0; ii < 5; ++ii) EXPECT_DOUBLE_EQ(2.0, h1(ii));
+	EXPECT_EQ(5, std::get<0>(h1.nbins()));
+}
+
+// A uniform 2D histogram must bin exactly as Histogram2D
+TEST(HistND, Matches2D) {
+	Histogram2D h0(7, 0.1, 0.4, 30, -1.0, 1.0000000001);
+	HistogramND<2> h1(HistAxis(7, 0.1, 0.4), HistAxis(30, -1.0, 1.0000000001));
+	unsigned int seed = 1;
+	for (int ii=0; ii < 10000; ++ii) {
+		seed = seed*1664525u + 1013904223u;
+		double x = 0.08 + 0.34*(seed/4294967296.0);
+		seed = seed*1664525u + 1013904223u;
+		double y = -1.01 + 2.02*(seed/4294967296.0);
+		h0.add(x, y, ii%3);
+		h1.add(x, y, ii%3);
+	}
+	for (int ii=0; ii < 7; ++ii) {
+		double x = std::get<0>(h0.xrange(ii));
+		for (int jj=0; jj < 30; ++jj) {
+			double y = std::get<0>(h0.yrange(jj));
+			EXPECT_EQ(x, std::get<0>(h1.xrange(ii)));
+			EXPECT_EQ(y, std::get<0>(h1.yrange(jj)));
+			h0.add(nextafter(x, -10.0), nextafter(y, -10.0), 1.0);
+			h1.add(nextafter(x, -10.0), nextafter(y, -10.0), 1.0);
+			h0.add(x, y, 2.0);
+			h1.add(x, y, 2.0);
+		}
+	}
+	for (int ii=0; ii < 7; ++ii)
+		for (int jj=0; jj<30; ++jj)
+			EXPECT_EQ(h0(ii,jj), h1(ii,jj));
+}
+
+TEST(HistND, Fill3D) {
+	Histogram3D h1(HistAxis(4, 1.0, 1.e4, HistAxis::Log), HistAxis(2, 0.0, 1.0), HistAxis(3, 0.0, 3.0));
+	EXPECT_EQ(24, h1.size());
+	h1.add(50.0, 0.7, 2.5);
+	h1.add({{50.0, 0.7, 2.5}}, 2.0);
+	h1.add(50.0, 0.7, 2.5, 0.5);
+	h1.add(0.5, 0.7, 2.5);
+	EXPECT_DOUBLE_EQ(3.5, h1(1, 1, 2));
+	EXPECT_DOUBLE_EQ(3.5, h1.data()[(1*2+1)*3+2]);
+
+	Histogram3D h2(h1);
+	h2.merge(h1);
+	EXPECT_DOUBLE_EQ(7.0, h2(1, 1, 2));
+	h2.reset();
+	for (int ii=0; ii < 24; ++ii) EXPECT_DOUBLE_EQ(0.0, h2.data()[ii]);
+}
+
+TEST(HistND, Count) {
+	HistogramND<2, CountAccumulator> h1(HistAxis(5, 0.0, 1.0), HistAxis(2, 0.0, 1.0));
+	h1.add(0.5, 0.75);
+	h1.add(0.5, 0.75, 2.0);
+	h1.add(1.5, 0.75);
+	EXPECT_EQ(3.0, h1(2,1));
+	EXPECT_EQ(3u, h1.data()[5]);
+}
@@ -16,3 +16,50 @@ TEST(Random, FillVector) {
 	std::vector<double> out = ran1(10);
 	EXPECT_EQ(10, out.size());
 }
+
+// Known answers, from the Random123 distribution
+TEST(Random, Philox) {
+	uint32_t out[4];
+	uint32_t c0[4] = {0, 0, 0, 0}, k0[2] = {0, 0};
+	uint32_t c1[4] = {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, k1[2] = {0xffffffff, 0xffffffff};
+	uint32_t c2[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, k2[2] = {0xa4093822, 0x299f31d0};
+	philox4x32(c0, k0, out);
+	EXPECT_EQ(0x6627e8d5u, out[0]); EXPECT_EQ(0xe169c58du, out[1]);
+	EXPECT_EQ(0xbc57ac4cu, out[2]); EXPECT_EQ(0x9b00dbd8u, out[3]);
+	philox4x32(c1, k1, out);
+	EXPECT_EQ(0x408f276du, out[0]); EXPECT_EQ(0x41c83b0eu, out[1]);
+	EXPECT_EQ(0xa20bc7c6u, out[2]); EXPECT_EQ(0x6d5451fdu, out[3]);
+	philox4x32(c2, k2, out);
+	EXPECT_EQ(0xd16cfe09u, out[0]); EXPECT_EQ(0x94fdccebu, out[1]);
+	EXPECT_EQ(0x5001e420u, out[2]); EXPECT_EQ(0x24126ea1u, out[3]);
+}
+
+TEST(Random, Streams) {
+	npRandom ran1(100, 3), ran2(100, 3), ran3(100, 4);
+	std::vector<double> x1 = ran1(1000), x3 = ran3(1000);
+	double sum = 0.0;
+	int nsame = 0;
+	for (int ii=0; ii < 1000; ++ii) {
+		EXPECT_GE(x1[ii], 0.0);
+		EXPECT_LT(x1[ii], 1.0);
+		EXPECT_EQ(x1[ii], npRandom::uniform(100, 3, ii));
+		nsame += (x1[ii] == x3[ii]);
+		sum += x1[ii];
+	}
+	EXPECT_EQ(0, nsame);
+	EXPECT_NEAR(0.5, sum/1000, 0.05);
+
+	// Jump around the stream
+	ran2.seek(517);
+	EXPECT_EQ(x1[517], ran2());
+	EXPECT_EQ(x1[518], ran2());
+	ran2.seek(3);
+	EXPECT_EQ(x1[3], ran2());
+
+	// The GSL distributions work too
+	Eigen::Vector3d vec = ran2.dir3d();
+	EXPECT_DOUBLE_EQ(1.0, vec.norm());
+
+	npRandom ran4(100);
+	EXPECT_ANY_THROW(ran4.seek(10));
+}
@@ -0,0 +1,85 @@
+#include "gtest/gtest.h"
+#include "npSpline2D.h"
+#include "npSpline.h"
+#include <vector>
+#include <cmath>
+
+using namespace std;
+
+// Set up a test fixture with a non-uniform grid, spanning several tiles
+class Spline2DTest : public ::testing::Test {
+protected:
+	int nx, ny;
+	vector<double> x, y;
+
+	virtual void SetUp() {
+		nx = 13; ny = 9;
+		x.resize(nx); y.resize(ny);
+		for (int ii=0; ii < nx; ++ii) x[ii] = 0.1*ii + 0.01*ii*ii;
+		for (int jj=0; jj < ny; ++jj) y[jj] = -1.0 + 0.3*jj*(1 + 0.1*jj);
+	}
+
+	// Points between and on the knots
+	vector<double> grid(const vector<double>& k) {
+		vector<double> out;
+		for (int ii=0; ii < k.size()-1; ++ii)
+			for (int ll=0; ll < 5; ++ll) out.push_back(k[ii] + 0.2*ll*(k[ii+1]-k[ii]));
+		out.push_back(k.back());
+		return out;
+	}
+};
+
+// Bilinear reproduces a + bx + cy + dxy
+TEST_F(Spline2DTest, Bilinear) {
+	vector<double> z(nx*ny);
+	for (int ii=0; ii < nx; ++ii)
+		for (int jj=0; jj < ny; ++jj) z[ii*ny+jj] = 1.0 + 2.0*x[ii] - 3.0*y[jj] + 0.5*x[ii]*y[jj];
+	Spline2D sp1(x, y, z, Spline2D::Bilinear);
+	EXPECT_EQ(Spline2D::Bilinear, sp1.type());
+	vector<double> xs = grid(x), ys = grid(y);
+	for (int ii=0; ii < xs.size(); ++ii)
+		for (int jj=0; jj < ys.size(); ++jj)
+			EXPECT_NEAR(1.0 + 2.0*xs[ii] - 3.0*ys[jj] + 0.5*xs[ii]*ys[jj], sp1(xs[ii], ys[jj]), 1.e-12);
+}
+
+// Bicubic is the tensor product of the 1D splines, so for a separable
+// function, it is the product of the 1D splines
+TEST_F(Spline2DTest, Bicubic) {
+	vector<double> gx(nx), hy(ny), z(nx*ny);
+	for (int ii=0; ii < nx; ++ii) gx[ii] = sin(3*x[ii]);
+	for (int jj=0; jj < ny; ++jj) hy[jj] = exp(y[jj]);
+	for (int ii=0; ii < nx; ++ii)
+		for (int jj=0; jj < ny; ++jj) z[ii*ny+jj] = gx[ii]*hy[jj];
+	Spline sx(x, gx), sy(y, hy);
+	Spline2D sp1(x, y, z);
+	EXPECT_EQ(Spline2D::Bicubic, sp1.type());
+	vector<double> xs = grid(x), ys = grid(y);
+	for (int ii=0; ii < xs.size(); ++ii)
+		for (int jj=0; jj < ys.size(); ++jj)
+			EXPECT_NEAR(sx(xs[ii])*sy(ys[jj]), sp1(xs[ii], ys[jj]), 1.e-12);
+}
+
+TEST_F(Spline2DTest, BatchAndCopy) {
+	vector<double> z(nx*ny);
+	for (int ii=0; ii < nx; ++ii)
+		for (int jj=0; jj < ny; ++jj) z[ii*ny+jj] = cos(x[ii]*y[jj]);
+	Spline2D *sp1 = new Spline2D(x, y, z);
+	Spline2D sp2(*sp1), sp3;
+	sp3 = std::move(*sp1);
+	delete sp1;
+
+	vector<double> xs, ys, zs;
+	for (int ii=0; ii < 1000; ++ii) {
+		xs.push_back(-0.1 + 2.9*((ii*37)%1000)/1000.0);
+		ys.push_back(-1.1 + 4.5*((ii*91)%1000)/1000.0);
+	}
+	zs.resize(xs.size());
+	sp3.eval(&xs[0], &ys[0], &zs[0], xs.size());
+	for (int ii=0; ii < xs.size(); ++ii) EXPECT_EQ(sp2(xs[ii], ys[ii]), zs[ii]);
+
+	// Along a grid line, this is the 1D spline
+	vector<double> zrow(z.begin() + 5*ny, z.begin() + 6*ny);
+	Spline srow(y, zrow);
+	vector<double> ys1 = grid(y);
+	for (int jj=0; jj < ys1.size(); ++jj) EXPECT_NEAR(srow(ys1[jj]), sp2(x[5], ys1[jj]), 1.e-12);
+}
@@ -0,0 +1,55 @@
+#include "gtest/gtest.h"
+#include "npSplineSampler.h"
+#include "npRandom.h"
+#include <vector>
+#include <cmath>
+
+using namespace std;
+
+// p(x) = x on [0, 2], so the CDF is x^2/4
+TEST(SplineSampler, Linear) {
+	int N = 11;
+	vector<double> x(N), y(N);
+	for (int ii=0; ii < N; ++ii) {
+		x[ii] = 0.2*ii;
+		y[ii] = x[ii];
+	}
+	Spline sp1(x, y, gsl_interp_linear);
+	EXPECT_NEAR(2.0, sp1.integral(0.0, 2.0), 1.e-14);
+	EXPECT_NEAR(-0.5, sp1.integral(1.0, 0.0), 1.e-14);
+
+	SplineSampler s1(sp1);
+	EXPECT_NEAR(2.0, s1.norm(), 1.e-14);
+	for (int ii=0; ii <= 100; ++ii) {
+		double xx = 0.02*ii, u = 0.01*ii;
+		EXPECT_NEAR(xx*xx/4, s1.cdf(xx), 1.e-14);
+		EXPECT_NEAR(2*sqrt(u), s1.quantile(u), 1.e-12);
+	}
+	EXPECT_EQ(0.0, s1.cdf(-1.0));
+	EXPECT_EQ(1.0, s1.cdf(3.0));
+	EXPECT_EQ(0.0, s1.quantile(0.0));
+	EXPECT_EQ(2.0, s1.quantile(1.0));
+}
+
+// A Gaussian-like n(z), with zeros at the ends
+TEST(SplineSampler, CSpline) {
+	int N = 101;
+	vector<double> x(N), y(N);
+	for (int ii=0; ii < N; ++ii) {
+		x[ii] = 0.02*ii;
+		y[ii] = x[ii]*x[ii]*exp(-pow(x[ii]/0.5, 1.5));
+	}
+	Spline sp1(x, y);
+	SplineSampler s1(sp1, 50);
+	EXPECT_NEAR(sp1.integral(0.0, 2.0), s1.norm(), 1.e-14);
+	EXPECT_NEAR(sp1.integral(0.0, 0.73), s1.cumulative(0.73), 1.e-14);
+
+	npRandom rnd(11);
+	vector<double> u(1000), z(1000);
+	for (int ii=0; ii < u.size(); ++ii) u[ii] = rnd();
+	s1.quantile(&u[0], &z[0], u.size());
+	for (int ii=0; ii < u.size(); ++ii) {
+		EXPECT_NEAR(u[ii], s1.cdf(z[ii]), 1.e-12);
+		EXPECT_EQ(s1.quantile(u[ii]), z[ii]);
+	}
+}
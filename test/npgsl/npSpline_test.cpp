@@ -2,6 +2,8 @@
 #include "npSpline.h"
 #include <vector>
 #include <algorithm>
+#include <cmath>
+#include <thread>
 
 using namespace std;
 
@@ -55,3 +57,90 @@ TEST_F(SplineTest, TestVal) {
 		EXPECT_NEAR(2.0*(ii+0.3), sp1(ii+0.3), 1.e-7);
 	}
 }
+
+TEST(Spline, BatchEval) {
+	int N = 1000;
+	vector<double> x(N), y(N);
+	for (int ii=0; ii < N; ++ii) {
+		x[ii] = 0.01*ii*(1+0.001*ii);
+		y[ii] = sin(x[ii]);
+	}
+	Spline sp1(x, y);
+
+	// Sorted, with repeats, steps smaller and larger than the knot spacing, and both ends
+	vector<double> xs, ys, ye;
+	xs.push_back(x[0]);
+	for (int ii=0; ii < 3000; ++ii) xs.push_back(x[N-1]*(ii/3000.0));
+	xs.push_back(xs.back());
+	for (int ii=0; ii < 10; ++ii) xs.push_back(x[N-1]*(0.99 + ii/1000.0));
+	xs.push_back(x[N-1]);
+	ys.resize(xs.size());
+	sp1.eval(&xs[0], &ys[0], xs.size());
+	for (int ii=0; ii < xs.size(); ++ii) EXPECT_EQ(sp1(xs[ii]), ys[ii]);
+
+	// Unsorted
+	reverse(xs.begin(), xs.end());
+	sp1.eval(&xs[0], &ys[0], xs.size());
+	for (int ii=0; ii < xs.size(); ++ii) EXPECT_EQ(sp1(xs[ii]), ys[ii]);
+}
+
+TEST(Spline, ThreadedEval) {
+	int N = 1000, nthreads = 4;
+	vector<double> x(N), y(N);
+	for (int ii=0; ii < N; ++ii) {
+		x[ii] = 0.01*ii;
+		y[ii] = sin(x[ii]);
+	}
+	Spline sp1(x, y);
+	const Spline& sp2 = sp1;
+
+	vector<double> y1(100000), y2(y1.size()), y3(y1.size());
+	vector<std::thread> threads;
+	for (int it=0; it < nthreads; ++it)
+		threads.push_back(std::thread([&, it]() {
+			gsl_interp_accel acc = {0, 0, 0};
+			for (size_t ii=it; ii < y1.size(); ii+=nthreads) {
+				double xx = x[N-1]*((ii*7919) % y1.size())/double(y1.size());
+				y1[ii] = sp2.eval(xx);
+				y2[ii] = sp2.eval(xx, &acc);
+			}
+		}));
+	for (size_t it=0; it < threads.size(); ++it) threads[it].join();
+
+	for (size_t ii=0; ii < y1.size(); ++ii) {
+		double xx = x[N-1]*((ii*7919) % y1.size())/double(y1.size());
+		y3[ii] = sp1(xx);
+		EXPECT_EQ(y3[ii], y1[ii]);
+		EXPECT_EQ(y3[ii], y2[ii]);
+	}
+}
+
+TEST_F(SplineTest, TestMove) {
+	vector<double> x(N), y(N);
+	for (int ii=0; ii < N; ++ii) {
+		x[ii] = ii;
+		y[ii] = 3*ii;
+	}
+	Spline sp2(std::move(x), std::move(y), gsl_interp_linear);
+	Spline sp3(std::move(sp2));
+	EXPECT_DOUBLE_EQ(7.5, sp3(2.5));
+	sp2 = std::move(sp3);
+	EXPECT_DOUBLE_EQ(7.5, sp2(2.5));
+	vector<Spline> splines;
+	splines.push_back(sp1);
+	splines.push_back(std::move(sp2));
+	EXPECT_DOUBLE_EQ(5.0, splines[0](2.5));
+	EXPECT_DOUBLE_EQ(7.5, splines[1](2.5));
+	EXPECT_DOUBLE_EQ(7.5, splines[1].eval(2.5));
+}
+
+// Copies share the table, and outlive the original
+TEST_F(SplineTest, TestShared) {
+	Spline *sp2 = new Spline(sp1);
+	Spline sp3;
+	sp3 = *sp2;
+	sp1 = Spline();
+	delete sp2;
+	for (int ii=0;ii < (N-1); ++ii)
+		EXPECT_NEAR(2.0*(ii+0.3), sp3(ii+0.3), 1.e-7);
+}
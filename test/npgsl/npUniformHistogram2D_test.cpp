@@ -0,0 +1,163 @@
+#include <cmath>
+#include "gtest/gtest.h"
+#include "npUniformHistogram2D.h"
+#include "npRandom.h"
+
+
+TEST(UniformHist2D, NxNy) {
+	UniformHistogram2D h1(5, 0.0, 1.0, 2, 0.0, 1.0);
+	std::tuple<int,int> tmp = h1.nbins();
+	EXPECT_EQ(5, std::get<0>(tmp));
+	EXPECT_EQ(2, std::get<1>(tmp));
+}
+
+TEST(UniformHist2D, XYRange) {
+	UniformHistogram2D h1(7, 0.1, 0.4, 3, -1.0, 1.0);
+	Histogram2D h0(7, 0.1, 0.4, 3, -1.0, 1.0);
+	for (int ii=0; ii < 7; ++ii) {
+		EXPECT_EQ(std::get<0>(h0.xrange(ii)), std::get<0>(h1.xrange(ii)));
+		EXPECT_EQ(std::get<1>(h0.xrange(ii)), std::get<1>(h1.xrange(ii)));
+	}
+	for (int jj=0; jj < 3; ++jj) {
+		EXPECT_EQ(std::get<0>(h0.yrange(jj)), std::get<0>(h1.yrange(jj)));
+		EXPECT_EQ(std::get<1>(h0.yrange(jj)), std::get<1>(h1.yrange(jj)));
+	}
+}
+
+TEST(UniformHist2D, Fill1) {
+	UniformHistogram2D h1(5, 0.0, 1.0, 2, 0.0, 1.0);
+	h1.add(1.1, -1.1, 10.0);
+	h1.add(0.5, 1.0, 10.0);
+	h1.add(-0.1, 0.3, 1.0);
+	h1.add(NAN, 0.3, 1.0);
+	for (int ii=0; ii < 5; ++ii)
+		for (int jj=0; jj<2; ++jj)
+			EXPECT_DOUBLE_EQ(0.0, h1(ii,jj));
+}
+
+TEST(UniformHist2D, Fill2) {
+	UniformHistogram2D h1(5, 0.0, 1.0, 2, 0.0, 1.0);
+	std::vector<double> xx, yy;
+	for (int ii=0; ii < 5; ++ii)
+		for (int jj=0; jj < 2; ++jj) {
+			xx.push_back(ii*0.2 + 0.1);
+			yy.push_back(jj*0.5 + 0.25);
+		}
+	h1.add(xx, yy, 3.14);
+	for (int ii=0; ii < 5; ++ii)
+		for (int jj=0; jj<2; ++jj)
+			EXPECT_DOUBLE_EQ(3.14, h1(ii,jj));
+}
+
+// The bins must match Histogram2D, including points on and next to the edges
+TEST(UniformHist2D, MatchesHistogram2D) {
+	UniformHistogram2D h1(7, 0.1, 0.4, 30, -1.0, 1.0000000001);
+	Histogram2D h0(7, 0.1, 0.4, 30, -1.0, 1.0000000001);
+	npRandom rnd(11);
+	for (int ii=0; ii < 100000; ++ii) {
+		double x = 0.08 + 0.34*rnd(), y = -1.01 + 2.02*rnd();
+		h0.add(x, y, ii%3);
+		h1.add(x, y, ii%3);
+	}
+	for (int ii=0; ii <= 7; ++ii) {
+		double x = (ii < 7) ? std::get<0>(h0.xrange(ii)) : std::get<1>(h0.xrange(6));
+		for (int jj=0; jj <= 30; ++jj) {
+			double y = (jj < 30) ? std::get<0>(h0.yrange(jj)) : std::get<1>(h0.yrange(29));
+			double xs[3] = {nextafter(x, -10.0), x, nextafter(x, 10.0)};
+			double ys[3] = {nextafter(y, -10.0), y, nextafter(y, 10.0)};
+			for (int kk=0; kk < 3; ++kk)
+				for (int ll=0; ll < 3; ++ll) {
+					h0.add(xs[kk], ys[ll], kk+3*ll);
+					h1.add(xs[kk], ys[ll], kk+3*ll);
+				}
+		}
+	}
+	Histogram2D h2 = h1.histogram();
+	for (int ii=0; ii < 7; ++ii)
+		for (int jj=0; jj<30; ++jj) {
+			EXPECT_EQ(h0(ii,jj), h1(ii,jj));
+			EXPECT_EQ(h0(ii,jj), h2(ii,jj));
+		}
+}
+
+TEST(UniformHist2D, Merge) {
+	UniformHistogram2D h1(5, 0.0, 1.0, 2, 0.0, 1.0), h2(5, 0.0, 1.0, 2, 0.0, 1.0);
+	for (int ii=0; ii < 5; ++ii)
+		for (int jj=0; jj < 2; ++jj) {
+			h1.add(ii*0.2+0.1, jj*0.5+0.25, 3.0);
+			if (ii%2==0) h2.add(ii*0.2+0.1, jj*0.5+0.25, 1.0);
+		}
+	h1.merge(h2);
+	for (int ii=0; ii < 5; ++ii)
+		for (int jj=0; jj<2; ++jj)
+			EXPECT_DOUBLE_EQ((ii%2==0) ? 4.0 : 3.0, h1(ii,jj));
+	h1.reset();
+	for (int ii=0; ii < 5; ++ii)
+		for (int jj=0; jj<2; ++jj)
+			EXPECT_DOUBLE_EQ(0.0, h1(ii,jj));
+}
+
+// Bins that are narrow compared to the offset, so the roundoff is large
+TEST(UniformHist2D, LargeOffset) {
+	UniformHistogram2D h1(1000, 1.e6, 1.e6+1.0, 2, 0.0, 1.0);
+	Histogram2D h0(1000, 1.e6, 1.e6+1.0, 2, 0.0, 1.0);
+	for (int ii=0; ii < 1000; ++ii) {
+		double x = std::get<0>(h0.xrange(ii));
+		double xs[3] = {nextafter(x, 0.0), x, nextafter(x, 2.e6)};
+		for (int kk=0; kk < 3; ++kk) {
+			h0.add(xs[kk], 0.3, kk+1);
+			h1.add(xs[kk], 0.3, kk+1);
+		}
+	}
+	for (int ii=0; ii < 1000; ++ii)
+		EXPECT_EQ(h0(ii,0), h1(ii,0));
+}
+
+// Unit weights onto a large total are lost in plain doubles
+TEST(UniformHist2D, Kahan) {
+	KahanUniformHistogram2D h1(2, 0.0, 1.0, 1, 0.0, 1.0), h2(2, 0.0, 1.0, 1, 0.0, 1.0);
+	UniformHistogram2D h0(2, 0.0, 1.0, 1, 0.0, 1.0);
+	h0.add(0.2, 0.5, 1.e16);
+	h1.add(0.2, 0.5, 1.e16);
+	for (int ii=0; ii < 1000; ++ii) {
+		h0.add(0.2, 0.5);
+		h1.add(0.2, 0.5);
+		h2.add(0.7, 0.5, 0.1);
+	}
+	EXPECT_EQ(1.e16, h0(0,0));
+	EXPECT_EQ(1.e16+1000, h1(0,0));
+	EXPECT_EQ(100.0, h2(1,0));
+	h1.merge(h2);
+	EXPECT_EQ(1.e16+1000, h1(0,0));
+	EXPECT_EQ(100.0, h2.histogram()(1,0));
+}
+
+TEST(UniformHist2D, Count) {
+	CountUniformHistogram2D h1(5, 0.0, 1.0, 2, 0.0, 1.0), h2(5, 0.0, 1.0, 2, 0.0, 1.0);
+	UniformHistogram2D h0(5, 0.0, 1.0, 2, 0.0, 1.0);
+	npRandom rnd(11);
+	for (int ii=0; ii < 10000; ++ii) {
+		double x = -0.1 + 1.2*rnd(), y = -0.1 + 1.2*rnd();
+		h0.add(x, y);
+		h1.add(x, y);
+		h2.add(x, y, 2.0);
+	}
+	h2.merge(h1);
+	Histogram2D h3 = h1.histogram();
+	for (int ii=0; ii < 5; ++ii)
+		for (int jj=0; jj<2; ++jj) {
+			EXPECT_EQ(h0(ii,jj), h1(ii,jj));
+			EXPECT_EQ(h0(ii,jj), h3(ii,jj));
+			EXPECT_EQ(3*h0(ii,jj), h2(ii,jj));
+			EXPECT_EQ(static_cast<uint64_t>(h0(ii,jj)), h1.data()[ii*2+jj]);
+		}
+}
+
+// Count weights must be non-negative integers
+TEST(UniformHist2D, CountWeight) {
+	CountUniformHistogram2D h1(5, 0.0, 1.0, 2, 0.0, 1.0);
+	EXPECT_THROW(h1.add(0.5, 0.5, 1.5), std::invalid_argument);
+	EXPECT_THROW(h1.add(0.5, 0.5, -1.0), std::invalid_argument);
+	EXPECT_THROW(h1.add(0.5, 0.5, NAN), std::invalid_argument);
+	EXPECT_EQ(0.0, h1(2,1));
+}
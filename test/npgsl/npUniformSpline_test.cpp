@@ -0,0 +1,91 @@
+#include "gtest/gtest.h"
+#include "npUniformSpline.h"
+#include "npSpline.h"
+#include <vector>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+// Compare UniformSpline and Spline over the knots, on a grid that hits
+// the knots and points between them
+void compare(const gsl_interp_type *sptype, bool periodic) {
+	int N = 41;
+	double xmin = 0.5, xmax = 3.0;
+	vector<double> x(N), y(N);
+	for (int ii=0; ii < N; ++ii) {
+		x[ii] = xmin + ii*(xmax-xmin)/(N-1);
+		y[ii] = periodic ? sin(2*M_PI*(x[ii]-xmin)/(xmax-xmin)) : exp(-x[ii])*cos(3*x[ii]);
+	}
+	x[N-1] = xmax;
+	if (periodic) y[N-1] = y[0];
+	Spline sp1(x, y, sptype);
+	UniformSpline sp2(xmin, xmax, y, sptype);
+	EXPECT_EQ(N, sp2.size());
+
+	vector<double> xs, ys;
+	for (int ii=0; ii <= 7*(N-1); ++ii) xs.push_back(xmin + ii*(xmax-xmin)/(7*(N-1)));
+	xs.back() = xmax;
+	ys.resize(xs.size());
+	sp2.eval(&xs[0], &ys[0], xs.size());
+	for (int ii=0; ii < xs.size(); ++ii) {
+		EXPECT_NEAR(sp1(xs[ii]), sp2(xs[ii]), 1.e-12);
+		EXPECT_EQ(sp2(xs[ii]), ys[ii]);
+	}
+}
+
+}
+
+TEST(UniformSpline, Linear) {
+	compare(gsl_interp_linear, false);
+}
+
+TEST(UniformSpline, CSpline) {
+	compare(gsl_interp_cspline, false);
+}
+
+TEST(UniformSpline, CSplinePeriodic) {
+	compare(gsl_interp_cspline_periodic, true);
+}
+
+TEST(UniformSpline, Akima) {
+	compare(gsl_interp_akima, false);
+}
+
+TEST(UniformSpline, AkimaPeriodic) {
+	compare(gsl_interp_akima_periodic, true);
+}
+
+// Not a piecewise cubic, so only approximate
+TEST(UniformSpline, Polynomial) {
+	int N = 6;
+	vector<double> x(N), y(N);
+	for (int ii=0; ii < N; ++ii) {
+		x[ii] = 0.2*ii;
+		y[ii] = exp(x[ii]);
+	}
+	Spline sp1(x, y, gsl_interp_polynomial);
+	UniformSpline sp2(0.0, 1.0, y, gsl_interp_polynomial);
+	for (int ii=0; ii <= 100; ++ii)
+		EXPECT_NEAR(sp1(0.01*ii), sp2(0.01*ii), 2.e-5);
+}
+
+TEST(UniformSpline, Extrapolate) {
+	vector<double> y(5);
+	for (int ii=0; ii < 5; ++ii) y[ii] = 2.0*ii;
+	UniformSpline sp1(0.0, 4.0, y, gsl_interp_linear);
+	EXPECT_NEAR(-2.0, sp1(-1.0), 1.e-12);
+	EXPECT_NEAR(10.0, sp1(5.0), 1.e-12);
+}
+
+// A spline needs at least two knots
+TEST(UniformSpline, TooFewKnots) {
+	UniformSpline sp1;
+	EXPECT_THROW(sp1(0.5), invalid_argument);
+	EXPECT_THROW(UniformSpline(0.0, 1.0, vector<double>()), invalid_argument);
+	EXPECT_THROW(UniformSpline(0.0, 1.0, vector<double>(1, 1.0)), invalid_argument);
+	EXPECT_THROW(UniformSpline(0.0, 1.0, vector<double>(2, 1.0)), invalid_argument);
+	EXPECT_NO_THROW(UniformSpline(0.0, 1.0, vector<double>(2, 1.0), gsl_interp_linear)(0.5));
+}
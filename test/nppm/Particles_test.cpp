@@ -15,7 +15,7 @@ void fillRandom2(TestParticles& p, int Ngrid) {
 	int rank;
 	float r1;
 	MPI_Comm_rank(PETSC_COMM_WORLD, &rank);
-	npRandom rr(99+100*rank);
+	npRandom rr(99, rank);
 	typename TestParticles::Index lo, hi;
 
 	npForEach(p, [&](ptest& ip) {